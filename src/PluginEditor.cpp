@@ -29,7 +29,6 @@ EQInfinityAudioProcessorEditor::EQInfinityAudioProcessorEditor(EQInfinityAudioPr
 
     updateGlobalControlLabels();
     selectBand(-1);
-    startTimerHz(20);
 }
 
 EQInfinityAudioProcessorEditor::~EQInfinityAudioProcessorEditor() {
@@ -53,6 +52,10 @@ void EQInfinityAudioProcessorEditor::resized() {
     auto plotBounds = bounds.reduced(6, 0);
 
     titleLabel_.setBounds(leftColumn.removeFromTop(34));
+    presetButton_.setBounds(leftColumn.removeFromTop(28).reduced(0, 2));
+    auto historyRow = leftColumn.removeFromTop(28).reduced(0, 2);
+    undoButton_.setBounds(historyRow.removeFromLeft(historyRow.getWidth() / 2 - 2));
+    redoButton_.setBounds(historyRow.withTrimmedLeft(4));
     outputGainLabel_.setBounds(leftColumn.removeFromTop(24));
     outputGainSlider_.setBounds(leftColumn.reduced(8, 8));
 
@@ -91,7 +94,9 @@ void EQInfinityAudioProcessorEditor::resized() {
     bandControls.removeFromLeft(controlGap);
     bandEnableToggle_.setBounds(bandControls.removeFromLeft(108).reduced(4));
     bandControls.removeFromLeft(controlGap);
-    bandTypeBox_.setBounds(bandControls.removeFromLeft(152).reduced(4));
+    auto typeArea = bandControls.removeFromLeft(152);
+    bandTypeBox_.setBounds(typeArea.removeFromTop(typeArea.getHeight() / 2).reduced(4));
+    bandShapeBox_.setBounds(typeArea.reduced(4));
     bandControls.removeFromLeft(controlGap);
     bandSlopeBox_.setBounds(bandControls.removeFromLeft(126).reduced(4));
     bandControls.removeFromLeft(controlGap);
@@ -121,14 +126,64 @@ void EQInfinityAudioProcessorEditor::resized() {
     }
 
     auto bandRow = bottomStrip.reduced(0, 8);
-    const int buttonWidth = bandRow.getWidth() / util::Params::NumBands;
-    for (int i = 0; i < util::Params::NumBands; ++i) {
+    const int numCells = shownBandCount_ + (addBandButton_.isVisible() ? 1 : 0);
+    const int buttonWidth = bandRow.getWidth() / juce::jmax(1, numCells);
+    for (int i = 0; i < shownBandCount_; ++i) {
         auto cell = bandRow.removeFromLeft(buttonWidth).reduced(4, 2);
         bandButtons_[static_cast<std::size_t>(i)].setBounds(cell);
     }
+    addBandButton_.setBounds(bandRow.removeFromLeft(buttonWidth).reduced(4, 2));
 }
 
-void EQInfinityAudioProcessorEditor::timerCallback() {
+bool EQInfinityAudioProcessorEditor::keyPressed(const juce::KeyPress& key) {
+    const auto undoKey = juce::KeyPress('z', juce::ModifierKeys::commandModifier, 0);
+    const auto redoKey =
+        juce::KeyPress('z', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier, 0);
+    if (key == undoKey || key == redoKey) {
+        auto& history = processor_.history();
+        if (key == undoKey)
+            history.undo();
+        else
+            history.redo();
+
+        updateHistoryButtons();
+        return true;
+    }
+
+    return false;
+}
+
+void EQInfinityAudioProcessorEditor::onVBlank() {
+    auto* peer = getPeer();
+    const bool showing = isShowing() && (peer == nullptr || !peer->isMinimised());
+    if (!showing) {
+        wasShowing_ = false;
+        return;
+    }
+
+    const double nowMs = juce::Time::getMillisecondCounterHiRes();
+    if (!wasShowing_) {
+        // Timing from before the window was hidden says nothing about the current display or load.
+        framePacer_.reset();
+        wasShowing_ = true;
+    }
+
+    if (!framePacer_.onVBlank(nowMs))
+        return;
+
+    if (nowMs - lastControlUpdateMs_ >= 1000.0 / ControlUpdateHz) {
+        lastControlUpdateMs_ = nowMs;
+        updateControls();
+    }
+
+    eqPlot_.updateFrame();
+
+    // Paints land between callbacks, so the plot's paint time is the previous frame's; close enough for pacing.
+    const double updateCostMs = juce::Time::getMillisecondCounterHiRes() - nowMs;
+    framePacer_.reportFrameCost(updateCostMs + eqPlot_.takePaintCostMs());
+}
+
+void EQInfinityAudioProcessorEditor::updateControls() {
     eqPlot_.setSampleRate(processor_.getSampleRate());
     enforceStereoEditTargetPolicy();
 
@@ -142,33 +197,10 @@ void EQInfinityAudioProcessorEditor::timerCallback() {
         rebuildSelectedBandAttachments();
     }
 
-    if (editTarget == util::EditTarget::Link && selectedBandIndex_ >= 0) {
-        const int bandNum = selectedBandIndex_ + 1;
-        auto& apvts = processor_.params().apvts;
-        auto mirrorField = [&](const juce::String& sourceID, const juce::String& destinationID) {
-            auto* source = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter(sourceID));
-            auto* destination = dynamic_cast<juce::RangedAudioParameter*>(apvts.getParameter(destinationID));
-            if (source == nullptr || destination == nullptr)
-                return;
-
-            const float sourceValue = source->convertFrom0to1(source->getValue());
-            const float destinationValue = destination->convertFrom0to1(destination->getValue());
-            if (std::abs(sourceValue - destinationValue) < 1.0e-6f)
-                return;
-
-            destination->setValueNotifyingHost(destination->convertTo0to1(sourceValue));
-        };
-
-        mirrorField(util::Params::IDs::enabled(bandNum, util::Bank::A),
-                    util::Params::IDs::enabled(bandNum, util::Bank::B));
-        mirrorField(util::Params::IDs::type(bandNum, util::Bank::A), util::Params::IDs::type(bandNum, util::Bank::B));
-        mirrorField(util::Params::IDs::freq(bandNum, util::Bank::A), util::Params::IDs::freq(bandNum, util::Bank::B));
-        mirrorField(util::Params::IDs::gain(bandNum, util::Bank::A), util::Params::IDs::gain(bandNum, util::Bank::B));
-        mirrorField(util::Params::IDs::q(bandNum, util::Bank::A), util::Params::IDs::q(bandNum, util::Bank::B));
-        mirrorField(util::Params::IDs::slope(bandNum, util::Bank::A), util::Params::IDs::slope(bandNum, util::Bank::B));
-    }
-
+    updateShownBands();
     updateBandButtonStyles();
+    updatePresetButton();
+    updateHistoryButtons();
 }
 
 void EQInfinityAudioProcessorEditor::configureControls() {
@@ -178,6 +210,30 @@ void EQInfinityAudioProcessorEditor::configureControls() {
     titleLabel_.setColour(juce::Label::textColourId, juce::Colour::fromRGB(225, 228, 231));
     addAndMakeVisible(titleLabel_);
 
+    presetButton_.setColour(juce::TextButton::buttonColourId, juce::Colour::fromRGB(53, 56, 61));
+    presetButton_.setColour(juce::TextButton::textColourOffId, juce::Colour::fromRGB(203, 206, 210));
+    presetButton_.onClick = [this] { showPresetBrowser(); };
+    addAndMakeVisible(presetButton_);
+    updatePresetButton();
+
+    for (auto* button : {&undoButton_, &redoButton_}) {
+        button->setColour(juce::TextButton::buttonColourId, juce::Colour::fromRGB(53, 56, 61));
+        button->setColour(juce::TextButton::textColourOffId, juce::Colour::fromRGB(203, 206, 210));
+        addAndMakeVisible(*button);
+    }
+    undoButton_.setButtonText("Undo");
+    redoButton_.setButtonText("Redo");
+    undoButton_.onClick = [this] {
+        processor_.history().undo();
+        updateHistoryButtons();
+    };
+    redoButton_.onClick = [this] {
+        processor_.history().redo();
+        updateHistoryButtons();
+    };
+    updateHistoryButtons();
+    setWantsKeyboardFocus(true);
+
     outputGainLabel_.setText("Output", juce::dontSendNotification);
     outputGainLabel_.setJustificationType(juce::Justification::centredLeft);
     outputGainLabel_.setColour(juce::Label::textColourId, juce::Colour::fromRGB(205, 208, 212));
@@ -201,10 +257,12 @@ void EQInfinityAudioProcessorEditor::configureControls() {
     bandEnableToggle_.setColour(juce::ToggleButton::textColourId, juce::Colour::fromRGB(215, 218, 221));
     addAndMakeVisible(bandEnableToggle_);
 
-    bandTypeBox_.addItemList({"Peak", "Low Shelf", "High Shelf", "High Pass", "Low Pass"}, 1);
-    bandSlopeBox_.addItemList({"12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct"}, 1);
+    bandTypeBox_.addItemList(util::Params::getFilterTypeNames(), 1);
+    bandSlopeBox_.addItemList(util::Params::getSlopeNames(), 1);
+    bandShapeBox_.addItemList(util::Params::getCutShapeNames(), 1);
     addAndMakeVisible(bandTypeBox_);
     addAndMakeVisible(bandSlopeBox_);
+    addAndMakeVisible(bandShapeBox_);
 
     stereoModeLabel_.setText("Mode", juce::dontSendNotification);
     stereoModeLabel_.setColour(juce::Label::textColourId, juce::Colour::fromRGB(205, 208, 212));
@@ -250,32 +308,94 @@ void EQInfinityAudioProcessorEditor::configureControls() {
     bandQSlider_.setColour(juce::Slider::trackColourId, juce::Colour::fromRGB(118, 227, 255));
     addAndMakeVisible(bandQSlider_);
 
-    for (int i = 0; i < util::Params::NumBands; ++i) {
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
         auto& button = bandButtons_[static_cast<std::size_t>(i)];
-        button.setButtonText("Band " + juce::String(i + 1));
         button.setColour(juce::TextButton::buttonColourId, juce::Colour::fromRGB(53, 56, 61));
         button.setColour(juce::TextButton::textColourOffId, juce::Colour::fromRGB(203, 206, 210));
         button.setColour(juce::TextButton::textColourOnId, juce::Colour::fromRGB(22, 24, 28));
         button.onClick = [this, i]() { selectBand(i); };
-        addAndMakeVisible(button);
+        addChildComponent(button);
     }
+
+    addBandButton_.setButtonText("+");
+    addBandButton_.setColour(juce::TextButton::buttonColourId, juce::Colour::fromRGB(53, 56, 61));
+    addBandButton_.setColour(juce::TextButton::textColourOffId, juce::Colour::fromRGB(203, 206, 210));
+    addBandButton_.onClick = [this] { eqPlot_.addBand(1000.0f, util::Params::defaultGainDb()); };
+    addChildComponent(addBandButton_);
+    updateShownBands();
+}
+
+void EQInfinityAudioProcessorEditor::showPresetBrowser() {
+    auto bank = processor_.presetBank();
+    browsedPresetBank_ = bank.get();
+    auto onPresetChosen = [this](int index) {
+        // Indices of a bank that has since been replaced would load from the wrong one.
+        if (processor_.presetBank().get() != browsedPresetBank_)
+            return;
+
+        processor_.setCurrentProgram(index);
+        updatePresetButton();
+    };
+    auto browser = std::make_unique<ui::PresetBrowser>(std::move(bank), processor_.getLoadedPreset(),
+                                                       std::move(onPresetChosen));
+    // Parented to the editor so that it, and its callback, go away with it.
+    presetCallOut_ = &juce::CallOutBox::launchAsynchronously(std::move(browser), presetButton_.getBounds(), this);
+}
+
+void EQInfinityAudioProcessorEditor::updatePresetButton() {
+    // The browser keeps its bank open, but once another bank is loaded it lists presets the processor no longer has.
+    if (presetCallOut_ != nullptr && processor_.presetBank().get() != browsedPresetBank_)
+        presetCallOut_->dismiss();
+
+    const int program = processor_.getLoadedPreset();
+    if (program == shownProgram_)
+        return;
+
+    shownProgram_ = program;
+    const auto name = processor_.getProgramName(program);
+    presetButton_.setButtonText(name.isNotEmpty() ? name : juce::String("Presets"));
+}
+
+void EQInfinityAudioProcessorEditor::updateHistoryButtons() {
+    undoButton_.setEnabled(processor_.history().canUndo());
+    redoButton_.setEnabled(processor_.history().canRedo());
 }
 
 void EQInfinityAudioProcessorEditor::selectBand(int bandIndex) {
-    if (bandIndex < 0 || bandIndex >= util::Params::NumBands)
+    if (bandIndex < 0 || bandIndex >= util::Params::MaxBands)
         selectedBandIndex_ = -1;
     else
         selectedBandIndex_ = bandIndex;
 
     eqPlot_.setSelectedBand(selectedBandIndex_);
     rebuildSelectedBandAttachments();
+    updateShownBands();
     updateBandButtonStyles();
 }
 
+void EQInfinityAudioProcessorEditor::updateShownBands() {
+    const int count = juce::jmax(processor_.params().getUsedBandCount(), selectedBandIndex_ + 1);
+    if (count == shownBandCount_)
+        return;
+
+    shownBandCount_ = count;
+    // Past the default count the buttons get too narrow for "Band N".
+    const bool compactLabels = count > util::Params::DefaultBandCount;
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
+        auto& button = bandButtons_[static_cast<std::size_t>(i)];
+        button.setVisible(i < count);
+        button.setButtonText(compactLabels ? juce::String(i + 1) : "Band " + juce::String(i + 1));
+    }
+
+    addBandButton_.setVisible(count < util::Params::MaxBands);
+    resized();
+}
+
 void EQInfinityAudioProcessorEditor::setBandControlsEnabled(bool enabled) {
     bandEnableToggle_.setEnabled(enabled);
     bandTypeBox_.setEnabled(enabled);
     bandSlopeBox_.setEnabled(enabled);
+    bandShapeBox_.setEnabled(enabled);
     bandFreqSlider_.setEnabled(enabled);
     bandGainSlider_.setEnabled(enabled);
     bandQSlider_.setEnabled(enabled);
@@ -285,27 +405,23 @@ void EQInfinityAudioProcessorEditor::enforceStereoEditTargetPolicy() {
     if (processor_.params().getStereoMode() != util::StereoMode::Stereo)
         return;
 
-    auto* editTargetParam = dynamic_cast<juce::RangedAudioParameter*>(
-        processor_.params().apvts.getParameter(util::Params::IDs::editTarget));
-    if (editTargetParam == nullptr)
+    if (processor_.params().getEditTarget() == util::EditTarget::Link)
         return;
 
-    const float currentValue = editTargetParam->convertFrom0to1(editTargetParam->getValue());
-    if (std::abs(currentValue - static_cast<float>(util::EditTarget::Link)) < 1.0e-6f)
-        return;
-
-    editTargetParam->setValueNotifyingHost(editTargetParam->convertTo0to1(static_cast<float>(util::EditTarget::Link)));
+    auto& editTargetParam = processor_.params().getEditTargetParameter();
+    editTargetParam.setValueNotifyingHost(editTargetParam.convertTo0to1(static_cast<float>(util::EditTarget::Link)));
 }
 
 void EQInfinityAudioProcessorEditor::rebuildSelectedBandAttachments() {
     bandEnableAttachment_.reset();
     bandTypeAttachment_.reset();
     bandSlopeAttachment_.reset();
+    bandShapeAttachment_.reset();
     bandFreqAttachment_.reset();
     bandGainAttachment_.reset();
     bandQAttachment_.reset();
 
-    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::NumBands) {
+    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::MaxBands) {
         selectedBandLabel_.setText("No Band", juce::dontSendNotification);
         setBandControlsEnabled(false);
         return;
@@ -324,7 +440,9 @@ void EQInfinityAudioProcessorEditor::rebuildSelectedBandAttachments() {
     bandTypeAttachment_ =
         std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::type(bandNum, bank), bandTypeBox_);
     bandSlopeAttachment_ =
-        std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::slope(bandNum, bank), bandSlopeBox_);
+        std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::cutSlope(bandNum, bank), bandSlopeBox_);
+    bandShapeAttachment_ =
+        std::make_unique<ComboBoxAttachment>(apvts, util::Params::IDs::cutShape(bandNum, bank), bandShapeBox_);
     bandFreqAttachment_ =
         std::make_unique<SliderAttachment>(apvts, util::Params::IDs::freq(bandNum, bank), bandFreqSlider_);
     bandGainAttachment_ =
@@ -336,27 +454,44 @@ void EQInfinityAudioProcessorEditor::rebuildSelectedBandAttachments() {
 }
 
 void EQInfinityAudioProcessorEditor::updateSelectedBandControlState() {
-    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::NumBands) {
+    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::MaxBands) {
         setBandControlsEnabled(false);
         return;
     }
 
     const auto typeIndex = bandTypeBox_.getSelectedItemIndex();
-    if (typeIndex < 0)
+    const auto slopeIndex = bandSlopeBox_.getSelectedItemIndex();
+    if (typeIndex < 0 || slopeIndex < 0)
         return;
 
     const auto type = static_cast<util::FilterType>(typeIndex);
     const bool usesGain =
         type == util::FilterType::Peak || type == util::FilterType::LowShelf || type == util::FilterType::HighShelf;
-    const bool usesSlope = type == util::FilterType::HighPass || type == util::FilterType::LowPass;
+    const bool usesSlope = util::isCutFilter(type);
+    const bool linkwitzRiley =
+        usesSlope && bandShapeBox_.getSelectedItemIndex() == static_cast<int>(util::CutShape::LinkwitzRiley);
+    // A Linkwitz-Riley cut has to stay flat to sum, and a 6 dB cut is first order; neither has a Q to set.
+    const bool firstOrder = slopeIndex == static_cast<int>(util::Slope::Slope6dB);
+    const bool usesQ = !linkwitzRiley && !(usesSlope && firstOrder);
 
     bandGainSlider_.setEnabled(usesGain);
     bandSlopeBox_.setEnabled(usesSlope);
+    bandShapeBox_.setEnabled(usesSlope);
+    bandQSlider_.setEnabled(usesQ);
+
+    // Linkwitz-Riley orders are even, so the editor never offers it together with an odd slope. Automation can still
+    // combine the two, and the band then runs at the next even order.
+    const bool oddOrder = util::getFilterOrder(static_cast<util::Slope>(slopeIndex)) % 2 != 0;
+    bandShapeBox_.setItemEnabled(static_cast<int>(util::CutShape::LinkwitzRiley) + 1, !oddOrder);
+    for (int i = 0; i < bandSlopeBox_.getNumItems(); ++i) {
+        const bool evenOrder = util::getFilterOrder(static_cast<util::Slope>(i)) % 2 == 0;
+        bandSlopeBox_.setItemEnabled(i + 1, evenOrder || !linkwitzRiley);
+    }
 }
 
 void EQInfinityAudioProcessorEditor::updateBandButtonStyles() {
     const auto bank = getAttachmentBank();
-    for (int i = 0; i < util::Params::NumBands; ++i) {
+    for (int i = 0; i < shownBandCount_; ++i) {
         auto& button = bandButtons_[static_cast<std::size_t>(i)];
         const auto& band = processor_.params().getBand(i, bank);
         const bool enabled = band.enabled->load(std::memory_order_relaxed) > 0.5f;
@@ -2,16 +2,21 @@
 
 #include "PluginProcessor.h"
 #include "ui/EqPlotComponent.h"
+#include "ui/FramePacer.h"
+#include "ui/PresetBrowser.h"
 #include "ui/SpectrumAnalyzer.h"
 #include <JuceHeader.h>
 
-class EQInfinityAudioProcessorEditor final : public juce::AudioProcessorEditor, private juce::Timer {
+// All periodic UI work runs from one display-synchronised callback: the plot every paced frame, the control state at
+// ControlUpdateHz. Nothing runs while the window is hidden or minimised.
+class EQInfinityAudioProcessorEditor final : public juce::AudioProcessorEditor {
   public:
     explicit EQInfinityAudioProcessorEditor(EQInfinityAudioProcessor& processor);
     ~EQInfinityAudioProcessorEditor() override;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
+    bool keyPressed(const juce::KeyPress& key) override;
 
   private:
     EQInfinityAudioProcessor& processor_;
@@ -21,14 +26,19 @@ class EQInfinityAudioProcessorEditor final : public juce::AudioProcessorEditor,
     // Left column
     juce::Slider outputGainSlider_;
     juce::Label titleLabel_;
+    juce::TextButton presetButton_;
+    juce::TextButton undoButton_;
+    juce::TextButton redoButton_;
     juce::Label outputGainLabel_;
 
     // Bottom strip controls
-    std::array<juce::TextButton, util::Params::NumBands> bandButtons_;
+    std::array<juce::TextButton, util::Params::MaxBands> bandButtons_;
+    juce::TextButton addBandButton_;
     juce::Label selectedBandLabel_;
     juce::ToggleButton bandEnableToggle_;
     juce::ComboBox bandTypeBox_;
     juce::ComboBox bandSlopeBox_;
+    juce::ComboBox bandShapeBox_;
     juce::Slider bandFreqSlider_;
     juce::Slider bandGainSlider_;
     juce::Slider bandQSlider_;
@@ -50,17 +60,39 @@ class EQInfinityAudioProcessorEditor final : public juce::AudioProcessorEditor,
     std::unique_ptr<ButtonAttachment> bandEnableAttachment_;
     std::unique_ptr<ComboBoxAttachment> bandTypeAttachment_;
     std::unique_ptr<ComboBoxAttachment> bandSlopeAttachment_;
+    std::unique_ptr<ComboBoxAttachment> bandShapeAttachment_;
     std::unique_ptr<SliderAttachment> bandFreqAttachment_;
     std::unique_ptr<SliderAttachment> bandGainAttachment_;
     std::unique_ptr<SliderAttachment> bandQAttachment_;
 
+    static constexpr double ControlUpdateHz = 20.0;
+
+    ui::FramePacer framePacer_;
+    double lastControlUpdateMs_ = 0.0;
+    bool wasShowing_ = false;
+
     int selectedBandIndex_ = -1;
+    // Band buttons are shown for the bands in use and the selected band; 0 until the first update.
+    int shownBandCount_ = 0;
+    // -1 is a state that did not come from a preset, so start below it to force the first update.
+    int shownProgram_ = -2;
+    // The open preset browser, if any, and the bank it shows; compared by address only.
+    juce::Component::SafePointer<juce::CallOutBox> presetCallOut_;
+    const util::PresetBank* browsedPresetBank_ = nullptr;
     util::EditTarget lastEditTarget_ = util::EditTarget::Link;
     util::StereoMode lastStereoMode_ = util::StereoMode::Stereo;
 
-    void timerCallback() override;
+    // Declared last so that it is detached before anything its callback touches is destroyed.
+    juce::VBlankAttachment vBlankAttachment_{this, [this] { onVBlank(); }};
+
+    void onVBlank();
+    void updateControls();
     void configureControls();
+    void showPresetBrowser();
+    void updatePresetButton();
+    void updateHistoryButtons();
     void selectBand(int bandIndex);
+    void updateShownBands();
     void setBandControlsEnabled(bool enabled);
     void enforceStereoEditTargetPolicy();
     void rebuildSelectedBandAttachments();
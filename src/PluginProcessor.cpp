@@ -11,6 +11,14 @@ EQInfinityAudioProcessor::EQInfinityAudioProcessor()
 #endif
                          ),
       params_(*this) {
+    params_.apvts.addParameterListener(util::Params::IDs::hqMode, this);
+    params_.apvts.state.addListener(this);
+}
+
+EQInfinityAudioProcessor::~EQInfinityAudioProcessor() {
+    params_.apvts.state.removeListener(this);
+    params_.apvts.removeParameterListener(util::Params::IDs::hqMode, this);
+    stopTimer();
 }
 
 const juce::String EQInfinityAudioProcessor::getName() const {
@@ -30,18 +38,62 @@ double EQInfinityAudioProcessor::getTailLengthSeconds() const {
     return 0.0;
 }
 
+// Programs are the presets of the open bank. Hosts expect at least one program, so an empty bank reports a single
+// unnamed one that does nothing.
 int EQInfinityAudioProcessor::getNumPrograms() {
-    return 1;
+    return juce::jmax(1, presetBank()->size());
 }
 int EQInfinityAudioProcessor::getCurrentProgram() {
-    return 0;
+    return juce::jmax(0, currentProgram_.load());
+}
+void EQInfinityAudioProcessor::setCurrentProgram(int index) {
+    loadPreset(index);
 }
-void EQInfinityAudioProcessor::setCurrentProgram(int) {}
-const juce::String EQInfinityAudioProcessor::getProgramName(int) {
-    return {};
+const juce::String EQInfinityAudioProcessor::getProgramName(int index) {
+    return presetBank()->getName(index);
 }
+// Banks are read-only.
 void EQInfinityAudioProcessor::changeProgramName(int, const juce::String&) {}
 
+juce::File EQInfinityAudioProcessor::getDefaultPresetBankFile() {
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+        .getChildFile("EQ Infinity")
+        .getChildFile("Presets.eqbank");
+}
+
+std::shared_ptr<const util::PresetBank> EQInfinityAudioProcessor::presetBank() const {
+    const juce::ScopedLock lock(presetBankLock_);
+    return presetBank_;
+}
+
+bool EQInfinityAudioProcessor::loadPresetBank(const juce::File& file) {
+    // Opened on the side and swapped in whole: the host may be reading program names and a browser may be showing the
+    // current bank, and reopening the shared default bank would pull it out from under every other instance.
+    auto bank = std::make_shared<util::PresetBank>();
+    const bool opened = bank->open(file);
+    std::shared_ptr<const util::PresetBank> previous = std::move(bank);
+    {
+        const juce::ScopedLock lock(presetBankLock_);
+        presetBank_.swap(previous);
+    }
+
+    // Whatever is loaded came from the old bank.
+    currentProgram_.store(-1);
+    updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    return opened;
+}
+
+bool EQInfinityAudioProcessor::loadPreset(int index) {
+    // Holding the bank keeps the state's mapping alive even if another bank is loaded meanwhile.
+    const auto bank = presetBank();
+    const auto state = bank->getState(index);
+    if (state.data == nullptr || !restoreState(state.data, state.size))
+        return false;
+
+    currentProgram_.store(index);
+    return true;
+}
+
 void EQInfinityAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
     processSpec_.sampleRate = sampleRate;
     processSpec_.maximumBlockSize = static_cast<juce::uint32>(samplesPerBlock);
@@ -51,12 +103,16 @@ void EQInfinityAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     eqEngineA_.prepare(processSpec_);
     eqEngineB_.prepare(processSpec_);
 
-    const auto numProcessingChannels =
-        static_cast<std::size_t>(juce::jmax(1, static_cast<int>(processSpec_.numChannels)));
-    oversampling2x_ = std::make_unique<juce::dsp::Oversampling<float>>(
-        numProcessingChannels, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false);
-    oversampling2x_->reset();
-    oversampling2x_->initProcessing(static_cast<std::size_t>(processSpec_.maximumBlockSize));
+    {
+        // Playback is stopped, so the old oversampler can be dropped here. It is only rebuilt now if HQ is on;
+        // otherwise it waits until HQ is first engaged.
+        const juce::ScopedLock lock(hqLock_);
+        hqSpec_ = processSpec_;
+        oversampling2x_.store(nullptr, std::memory_order_release);
+        oversamplingStorage_.reset();
+        if (params_.isHQEnabled())
+            createOversamplingLocked();
+    }
 
     outputGain_.reset();
     outputGain_.prepare(processSpec_);
@@ -66,19 +122,31 @@ void EQInfinityAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     const auto gainDb = params_.getOutputGainDb();
     outputGain_.setGainDecibels(gainDb);
 
-    preAnalyzerFifo_.clear();
-    postAnalyzerFifo_.clear();
+    // An attached reader may be mid-frame on a pool thread, so it drops the stale samples itself.
+    const juce::ScopedLock lock(analyzerLock_);
+    if (analyzerStorage_ != nullptr)
+        analyzerStorage_->requestDiscard();
 }
 
 void EQInfinityAudioProcessor::releaseResources() {
-    if (oversampling2x_ != nullptr)
-        oversampling2x_->reset();
+    {
+        const juce::ScopedLock lock(hqLock_);
+        if (params_.isHQEnabled() && oversamplingStorage_ != nullptr) {
+            oversamplingStorage_->reset();
+        } else {
+            oversampling2x_.store(nullptr, std::memory_order_release);
+            oversamplingStorage_.reset();
+        }
+    }
 
     eqEngineA_.reset();
     eqEngineB_.reset();
 
-    preAnalyzerFifo_.clear();
-    postAnalyzerFifo_.clear();
+    const juce::ScopedLock lock(analyzerLock_);
+    if (analyzerConsumers_ == 0)
+        releaseUnusedAnalyzerLocked();
+    else
+        analyzerStorage_->requestDiscard();
 }
 
 #if !JucePlugin_PreferredChannelConfigurations
@@ -109,13 +177,31 @@ void EQInfinityAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     for (int ch = totalNumInputChannels; ch < totalNumOutputChannels; ++ch)
         buffer.clear(ch, 0, buffer.getNumSamples());
 
-    if (totalNumInputChannels > 0)
-        preAnalyzerFifo_.push(buffer.getReadPointer(0), buffer.getNumSamples());
+    // All analyzer planes are filled into one reservation and published together at the end of the block. With no
+    // editor attached the taps are skipped entirely.
+    auto* analyzerFifo = activeAnalyzerFifo_.load(std::memory_order_acquire);
+    if (analyzerFifo != nullptr) {
+        analyzerFifoInUse_.store(analyzerFifo);
+        if (activeAnalyzerFifo_.load() != analyzerFifo) {
+            // Detached in between; the message thread may free it as soon as the claim is dropped.
+            analyzerFifoInUse_.store(nullptr, std::memory_order_release);
+            analyzerFifo = nullptr;
+        }
+    }
+
+    if (analyzerFifo != nullptr) {
+        analyzerFifo->beginWrite(buffer.getNumSamples());
+        const float* preLeft = totalNumInputChannels > 0 ? buffer.getReadPointer(0) : nullptr;
+        analyzerFifo->writePlane(PreAnalyzerLeftPlane, preLeft);
+        analyzerFifo->writePlane(PreAnalyzerRightPlane,
+                                 totalNumInputChannels > 1 ? buffer.getReadPointer(1) : preLeft);
+    }
 
     const bool canUseMidSide = totalNumInputChannels >= 2 && totalNumOutputChannels >= 2;
     const bool useMidSide = canUseMidSide && params_.getStereoMode() == util::StereoMode::MidSide;
     const bool useLeftRight = canUseMidSide && params_.getStereoMode() == util::StereoMode::LeftRight;
-    const bool useHQ = oversampling2x_ != nullptr && params_.isHQEnabled();
+    auto* const oversampling = oversampling2x_.load(std::memory_order_acquire);
+    const bool useHQ = oversampling != nullptr && params_.isHQEnabled();
     const int soloBandIndex = soloBandIndex_.load(std::memory_order_relaxed);
 
     eqEngineA_.setSoloBandIndex(soloBandIndex);
@@ -146,9 +232,9 @@ void EQInfinityAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
 
     if (useHQ) {
         juce::dsp::AudioBlock<float> block(buffer);
-        auto upsampledBlock = oversampling2x_->processSamplesUp(block);
+        auto upsampledBlock = oversampling->processSamplesUp(block);
         processMode(upsampledBlock, static_cast<int>(upsampledBlock.getNumSamples()), processSpec_.sampleRate * 2.0);
-        oversampling2x_->processSamplesDown(block);
+        oversampling->processSamplesDown(block);
     } else {
         juce::dsp::AudioBlock<float> block(buffer);
         processMode(block, buffer.getNumSamples(), processSpec_.sampleRate);
@@ -162,8 +248,14 @@ void EQInfinityAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
     if (useMidSide)
         decodeMidSide(buffer);
 
-    if (totalNumOutputChannels > 0)
-        postAnalyzerFifo_.push(buffer.getReadPointer(0), buffer.getNumSamples());
+    if (analyzerFifo != nullptr) {
+        const float* postLeft = totalNumOutputChannels > 0 ? buffer.getReadPointer(0) : nullptr;
+        analyzerFifo->writePlane(PostAnalyzerLeftPlane, postLeft);
+        analyzerFifo->writePlane(PostAnalyzerRightPlane,
+                                 totalNumOutputChannels > 1 ? buffer.getReadPointer(1) : postLeft);
+        analyzerFifo->finishWrite();
+        analyzerFifoInUse_.store(nullptr, std::memory_order_release);
+    }
 }
 
 bool EQInfinityAudioProcessor::hasEditor() const {
@@ -175,33 +267,176 @@ juce::AudioProcessorEditor* EQInfinityAudioProcessor::createEditor() {
 }
 
 void EQInfinityAudioProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    // APVTS -> XML -> binary
-    auto state = params_.apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    stateSerializer_.save(destData);
 }
 
 void EQInfinityAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState == nullptr)
+    const bool restored = restoreState(data, sizeInBytes);
+    // The session's state is not a preset of the bank, whichever one was last loaded.
+    if (restored)
+        currentProgram_.store(-1);
+    // A binary chunk that fails is truncated, corrupt or from a newer version; the current state is kept.
+    jassert(restored || !util::StateSerializer::isBinaryState(data, sizeInBytes));
+    juce::ignoreUnused(restored);
+}
+
+bool EQInfinityAudioProcessor::restoreState(const void* data, int sizeInBytes) {
+    // The host's state thread and the message thread (presets) may both get here; each engine's recall handoff takes
+    // one writer at a time, and two interleaved loads would mix their parameters anyway.
+    const juce::ScopedLock lock(stateLock_);
+    // Restored parameter by parameter, so mirroring would let whichever bank loads last overwrite the other, and
+    // forwarding could let a legacy slope overwrite the cut slope the state holds.
+    linkMirror_.setSuspended(true);
+    legacySlopeForwarder_.setSuspended(true);
+    const bool restored = util::StateSerializer::isBinaryState(data, sizeInBytes)
+                              ? stateSerializer_.load(data, sizeInBytes)
+                              : stateSerializer_.loadLegacyXml(data, sizeInBytes);
+    legacySlopeForwarder_.setSuspended(false);
+    linkMirror_.setSuspended(false);
+    linkMirror_.synchronise();
+
+    if (restored) {
+        // Hosts may restore sessions from a background thread; the history belongs to the message thread.
+        if (juce::MessageManager::existsAndIsCurrentThread()) {
+            history_.clear();
+        } else {
+            historyClearRequested_.store(true, std::memory_order_release);
+            startTimer(UpkeepIntervalMs);
+        }
+        // Not the audio thread either way, and an XML state replaces the tree without any property change to react to.
+        buildOversamplingIfNeeded();
+        recallEngines();
+    }
+
+    return restored;
+}
+
+void EQInfinityAudioProcessor::recallEngines() {
+    // Before the first prepareToPlay there is nothing playing to fade from.
+    const double baseRate = processSpec_.sampleRate;
+    if (baseRate <= 0.0)
         return;
 
-    if (!xmlState->hasTagName(params_.apvts.state.getType()))
+    const bool hqActive = oversampling2x_.load(std::memory_order_acquire) != nullptr && params_.isHQEnabled();
+    const double processingRate = hqActive ? baseRate * 2.0 : baseRate;
+    eqEngineA_.prepareRecall(params_, util::Bank::A, processingRate);
+    eqEngineB_.prepareRecall(params_, util::Bank::B, processingRate);
+}
+
+std::size_t EQInfinityAudioProcessor::getMemoryFootprintBytes() const {
+    std::size_t bytes = sizeof(*this) + history_.getMemoryFootprintBytes() - sizeof(history_);
+    bytes += eqEngineA_.getMemoryFootprintBytes() - sizeof(eqEngineA_);
+    bytes += eqEngineB_.getMemoryFootprintBytes() - sizeof(eqEngineB_);
+
+    if (const auto bank = presetBank(); bank != defaultPresetBank_->bank) {
+        bytes += bank->getMemoryFootprintBytes();
+    } else {
+        // The default bank is shared; each instance carries its share.
+        const auto sharers = static_cast<std::size_t>(juce::jmax(1, defaultPresetBank_.getReferenceCount()));
+        bytes += bank->getMemoryFootprintBytes() / sharers;
+    }
+
+    {
+        const juce::ScopedLock lock(hqLock_);
+        if (oversamplingStorage_ != nullptr) {
+            // Oversampling does not report its allocations; the 2x working buffer per channel dominates them.
+            bytes += sizeof(juce::dsp::Oversampling<float>) +
+                     sizeof(float) * 2 * hqSpec_.numChannels * static_cast<std::size_t>(hqSpec_.maximumBlockSize);
+        }
+    }
+
+    const juce::ScopedLock lock(analyzerLock_);
+    if (analyzerStorage_ != nullptr)
+        bytes += AnalyzerFifo::getMemoryFootprintBytes();
+
+    return bytes;
+}
+
+void EQInfinityAudioProcessor::parameterChanged(const juce::String& parameterID, float newValue) {
+    // May arrive on the audio thread (automation), where even posting a message can block. Such a change reaches
+    // valueTreePropertyChanged() once the APVTS copies it into its tree on the message thread.
+    if (parameterID == util::Params::IDs::hqMode && newValue >= 0.5f &&
+        juce::MessageManager::existsAndIsCurrentThread())
+        buildOversamplingIfNeeded();
+}
+
+void EQInfinityAudioProcessor::valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier& property) {
+    if (property == juce::Identifier("value") && tree.getProperty("id").toString() == util::Params::IDs::hqMode &&
+        juce::MessageManager::existsAndIsCurrentThread())
+        buildOversamplingIfNeeded();
+}
+
+void EQInfinityAudioProcessor::timerCallback() {
+    // Runs only while there is work left; whatever adds work restarts it.
+    stopTimer();
+
+    if (historyClearRequested_.exchange(false, std::memory_order_acquire))
+        history_.clear();
+
+    const juce::ScopedLock lock(analyzerLock_);
+    if (analyzerConsumers_ == 0)
+        releaseUnusedAnalyzerLocked();
+}
+
+void EQInfinityAudioProcessor::buildOversamplingIfNeeded() {
+    const juce::ScopedLock lock(hqLock_);
+    if (oversamplingStorage_ == nullptr && params_.isHQEnabled())
+        createOversamplingLocked();
+}
+
+void EQInfinityAudioProcessor::createOversamplingLocked() {
+    // Not prepared yet; prepareToPlay will build it.
+    if (hqSpec_.maximumBlockSize == 0)
         return;
 
-    params_.apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    const auto numProcessingChannels = static_cast<std::size_t>(juce::jmax(1, static_cast<int>(hqSpec_.numChannels)));
+    oversamplingStorage_ = std::make_unique<juce::dsp::Oversampling<float>>(
+        numProcessingChannels, 1, juce::dsp::Oversampling<float>::filterHalfBandPolyphaseIIR, true, false);
+    oversamplingStorage_->reset();
+    oversamplingStorage_->initProcessing(static_cast<std::size_t>(hqSpec_.maximumBlockSize));
+    oversampling2x_.store(oversamplingStorage_.get(), std::memory_order_release);
+}
+
+EQInfinityAudioProcessor::AnalyzerFifo& EQInfinityAudioProcessor::attachAnalyzer() {
+    const juce::ScopedLock lock(analyzerLock_);
+
+    if (analyzerStorage_ == nullptr)
+        analyzerStorage_ = std::make_unique<AnalyzerFifo>();
+
+    if (analyzerConsumers_++ == 0) {
+        // No reader exists yet, so dropping whatever a previous consumer left unread is safe here.
+        analyzerStorage_->finishRead(analyzerStorage_->getNumReady());
+        activeAnalyzerFifo_.store(analyzerStorage_.get(), std::memory_order_release);
+    }
+
+    return *analyzerStorage_;
 }
 
-int EQInfinityAudioProcessor::popPreAnalyzerSamples(float* destination, int maxSamples) noexcept {
-    return preAnalyzerFifo_.pull(destination, maxSamples);
+void EQInfinityAudioProcessor::detachAnalyzer() noexcept {
+    const juce::ScopedLock lock(analyzerLock_);
+    jassert(analyzerConsumers_ > 0);
+
+    if (--analyzerConsumers_ == 0) {
+        activeAnalyzerFifo_.store(nullptr);
+        releaseUnusedAnalyzerLocked();
+    }
 }
 
-int EQInfinityAudioProcessor::popPostAnalyzerSamples(float* destination, int maxSamples) noexcept {
-    return postAnalyzerFifo_.pull(destination, maxSamples);
+void EQInfinityAudioProcessor::releaseUnusedAnalyzerLocked() {
+    jassert(analyzerConsumers_ == 0);
+    if (analyzerStorage_ == nullptr)
+        return;
+
+    // Sequentially consistent with the audio thread's claim: if it is not holding the storage now, it will see the
+    // cleared active pointer before it could claim it again. If it is mid-block, the timer retries shortly.
+    if (analyzerFifoInUse_.load() != analyzerStorage_.get())
+        analyzerStorage_.reset();
+    else
+        startTimer(UpkeepIntervalMs);
 }
 
 void EQInfinityAudioProcessor::setSoloBandIndex(int index) noexcept {
-    soloBandIndex_.store(juce::jlimit(-1, util::Params::NumBands - 1, index), std::memory_order_relaxed);
+    soloBandIndex_.store(juce::jlimit(-1, util::Params::MaxBands - 1, index), std::memory_order_relaxed);
 }
 
 void EQInfinityAudioProcessor::clearSoloBand() noexcept {
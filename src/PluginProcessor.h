@@ -1,14 +1,23 @@
 #pragma once
 
 #include "dsp/EqEngine.h"
+#include "util/AnalyzerFifo.h"
+#include "util/LegacySlopeForwarder.h"
+#include "util/LinkMirror.h"
+#include "util/ParameterHistory.h"
 #include "util/Params.h"
+#include "util/PresetBank.h"
+#include "util/StateSerializer.h"
 #include <JuceHeader.h>
 #include <array>
 
-class EQInfinityAudioProcessor final : public juce::AudioProcessor {
+class EQInfinityAudioProcessor final : public juce::AudioProcessor,
+                                       private juce::AudioProcessorValueTreeState::Listener,
+                                       private juce::ValueTree::Listener,
+                                       private juce::Timer {
   public:
     EQInfinityAudioProcessor();
-    ~EQInfinityAudioProcessor() override = default;
+    ~EQInfinityAudioProcessor() override;
 
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
@@ -43,73 +52,111 @@ class EQInfinityAudioProcessor final : public juce::AudioProcessor {
     void getStateInformation(juce::MemoryBlock& destData) override;
     void setStateInformation(const void* data, int sizeInBytes) override;
 
+    // The bank behind the program API. Opening a bank and loading presets happen on the message thread; switching
+    // presets costs a lookup and a state load, however large the bank. The default bank is mapped and indexed once
+    // per process and shared by every instance; loadPresetBank() gives this instance its own. A bank stays open for
+    // as long as anyone holds the pointer, so a caller may keep using it after another bank has been loaded.
+    static juce::File getDefaultPresetBankFile();
+    [[nodiscard]] std::shared_ptr<const util::PresetBank> presetBank() const;
+    bool loadPresetBank(const juce::File& file);
+    bool loadPreset(int index);
+    // The preset the current state was loaded from, or -1 once a session state has replaced it. Hosts still see
+    // getCurrentProgram(), which never goes negative.
+    [[nodiscard]] int getLoadedPreset() const noexcept { return currentProgram_.load(); }
+
+    // Undo/redo of UI edits. Message thread only; cleared whenever a state or preset is loaded (shortly after, from a
+    // timer, if the host loaded the state from another thread).
+    util::ParameterHistory& history() noexcept { return history_; }
+
     util::Params& params() noexcept { return params_; }
     const util::Params& params() const noexcept { return params_; }
 
-    int popPreAnalyzerSamples(float* destination, int maxSamples) noexcept;
-    int popPostAnalyzerSamples(float* destination, int maxSamples) noexcept;
+    // Pre- and post-EQ left/right planes, written once per block (mono repeats the left channel). Read by the
+    // spectrum analyzer only; mid/side and sums are derived there, not on the audio thread.
+    static constexpr int PreAnalyzerLeftPlane = 0;
+    static constexpr int PreAnalyzerRightPlane = 1;
+    static constexpr int PostAnalyzerLeftPlane = 2;
+    static constexpr int PostAnalyzerRightPlane = 3;
+    using AnalyzerFifo = util::AnalyzerFifo<4>;
+
+    // Message thread. The FIFO is allocated on the first attach, only written while a consumer is attached, and
+    // freed when the last one detaches (or, if the audio thread is mid-block with it, from a timer shortly after), so
+    // a closed editor costs neither memory nor audio-thread work. The reference stays valid until detachAnalyzer().
+    AnalyzerFifo& attachAnalyzer();
+    void detachAnalyzer() noexcept;
     void setSoloBandIndex(int index) noexcept;
     void clearSoloBand() noexcept;
 
+    // Bytes held by this instance: the object itself, the undo history, the EQ filter state, the lazily created HQ
+    // and analyzer resources and the preset bank index (a share of it for the default bank). Parameter state and
+    // JUCE's own bookkeeping are not included.
+    [[nodiscard]] std::size_t getMemoryFootprintBytes() const;
+
     util::Params params_;
 
   private:
-    class AnalyzerFifo final {
-      public:
-        static constexpr int Capacity = 1 << 15;
-
-        AnalyzerFifo() : fifo_(Capacity) {}
-
-        void clear() noexcept { fifo_.reset(); }
-
-        void push(const float* samples, int numSamples) noexcept {
-            if (samples == nullptr || numSamples <= 0)
-                return;
-
-            const int writableSamples = juce::jmin(numSamples, fifo_.getFreeSpace());
-            if (writableSamples <= 0)
-                return;
-
-            const auto write = fifo_.write(writableSamples);
-            juce::FloatVectorOperations::copy(buffer_.data() + write.startIndex1, samples, write.blockSize1);
-            if (write.blockSize2 > 0) {
-                juce::FloatVectorOperations::copy(buffer_.data() + write.startIndex2, samples + write.blockSize1,
-                                                  write.blockSize2);
-            }
-        }
-
-        int pull(float* destination, int maxSamples) noexcept {
-            if (destination == nullptr || maxSamples <= 0)
-                return 0;
-
-            const int readableSamples = juce::jmin(maxSamples, fifo_.getNumReady());
-            if (readableSamples <= 0)
-                return 0;
-
-            const auto read = fifo_.read(readableSamples);
-            juce::FloatVectorOperations::copy(destination, buffer_.data() + read.startIndex1, read.blockSize1);
-            if (read.blockSize2 > 0) {
-                juce::FloatVectorOperations::copy(destination + read.blockSize1, buffer_.data() + read.startIndex2,
-                                                  read.blockSize2);
-            }
-
-            return readableSamples;
-        }
-
-      private:
-        juce::AbstractFifo fifo_;
-        std::array<float, Capacity> buffer_{};
+    struct DefaultPresetBank {
+        DefaultPresetBank() { bank->open(getDefaultPresetBankFile()); }
+        std::shared_ptr<util::PresetBank> bank = std::make_shared<util::PresetBank>();
     };
 
+    // Keeps bank B in step with bank A while the edit target is Link, editor open or not.
+    util::LinkMirror linkMirror_{params_};
+    util::LegacySlopeForwarder legacySlopeForwarder_{params_};
+    util::StateSerializer stateSerializer_{params_};
+    juce::SharedResourcePointer<DefaultPresetBank> defaultPresetBank_;
+    // Only ever replaced as a whole, under presetBankLock_; never taken by the audio thread.
+    mutable juce::CriticalSection presetBankLock_;
+    std::shared_ptr<const util::PresetBank> presetBank_{defaultPresetBank_->bank};
+    util::ParameterHistory history_{*this};
+    std::atomic<int> currentProgram_{0};
     ::dsp::EqEngine eqEngineA_;
     ::dsp::EqEngine eqEngineB_;
     juce::dsp::Gain<float> outputGain_;
     juce::dsp::ProcessSpec processSpec_{};
-    std::unique_ptr<juce::dsp::Oversampling<float>> oversampling2x_;
-    AnalyzerFifo preAnalyzerFifo_;
-    AnalyzerFifo postAnalyzerFifo_;
+    // Serialises restoreState() and with it the engines' recall handoff, which has a single producer. Never taken by
+    // the audio thread.
+    juce::CriticalSection stateLock_;
+    // HQ resources exist only once HQ has been engaged. They are built off the audio thread (in prepareToPlay, after a
+    // state load, or on the message thread once the parameter changes) and handed over through oversampling2x_; until
+    // then HQ blocks run at the base rate. hqLock_ is never taken by the audio thread.
+    juce::CriticalSection hqLock_;
+    std::unique_ptr<juce::dsp::Oversampling<float>> oversamplingStorage_;
+    juce::dsp::ProcessSpec hqSpec_{};
+    std::atomic<juce::dsp::Oversampling<float>*> oversampling2x_{nullptr};
+    // Set when a state is restored off the message thread; the timer clears the history.
+    std::atomic<bool> historyClearRequested_{false};
+    // Guards analyzerStorage_ and analyzerConsumers_ against prepareToPlay/releaseResources; never taken by the
+    // audio thread, which only sees activeAnalyzerFifo_ and analyzerFifoInUse_.
+    juce::CriticalSection analyzerLock_;
+    std::unique_ptr<AnalyzerFifo> analyzerStorage_;
+    int analyzerConsumers_ = 0;
+    std::atomic<AnalyzerFifo*> activeAnalyzerFifo_{nullptr};
+    // The FIFO the audio thread is writing this block, published before it re-checks activeAnalyzerFifo_: once the
+    // active pointer is cleared and this does not hold the storage, the audio thread cannot reach it any more.
+    std::atomic<AnalyzerFifo*> analyzerFifoInUse_{nullptr};
     std::atomic<int> soloBandIndex_{-1};
 
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    // Sees hq_mode changes made on the audio thread, once the APVTS has flushed them to its tree.
+    void valueTreePropertyChanged(juce::ValueTree& tree, const juce::Identifier& property) override;
+    // Message-thread upkeep that could not be done where it arose: clears the history after an off-thread state load
+    // and frees a detached analyzer FIFO. Started on demand and stopped once nothing is left, so an idle instance
+    // never wakes up.
+    void timerCallback() override;
+    static constexpr int UpkeepIntervalMs = 50;
+    // Not on the audio thread.
+    void buildOversamplingIfNeeded();
+    void createOversamplingLocked();
+    // Frees the FIFO once nothing is attached and the audio thread is done with it; otherwise starts the timer to
+    // retry.
+    void releaseUnusedAnalyzerLocked();
+    // Loads a binary or legacy XML state, keeping Link mirroring out of the way; false if nothing was loaded. Takes
+    // stateLock_, so loads from different threads run one after the other.
+    bool restoreState(const void* data, int sizeInBytes);
+    // Moves both engines to the freshly loaded parameters with a short crossfade instead of a smoother sweep.
+    void recallEngines();
+
     static void encodeMidSide(juce::AudioBuffer<float>& buffer) noexcept;
     static void decodeMidSide(juce::AudioBuffer<float>& buffer) noexcept;
 
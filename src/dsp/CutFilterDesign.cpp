@@ -0,0 +1,151 @@
+#include "CutFilterDesign.h"
+#include <juce_dsp/juce_dsp.h>
+
+namespace dsp {
+namespace {
+
+using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+
+// The analog Q of each section of one cascade, lowest first; 0 marks a first-order section.
+struct SectionQs {
+    std::array<double, CutFilterDesign::MaxSections> q{};
+    int numSections = 0;
+};
+
+// Indexed by filter order; entry 0 is unused, as are the odd entries of the Linkwitz-Riley table.
+using QTable = std::array<SectionQs, CutFilterDesign::MaxOrder + 1>;
+
+constexpr double Pi = 3.14159265358979323846;
+
+// std::cos is not constexpr; on [0, pi / 2] twenty Taylor terms are exact to double precision.
+constexpr double constexprCos(double x) noexcept {
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n <= 20; ++n) {
+        term *= -x * x / static_cast<double>((2 * n - 1) * (2 * n));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr SectionQs makeButterworth(int order) noexcept {
+    SectionQs result;
+    if (order % 2 != 0)
+        result.q[static_cast<std::size_t>(result.numSections++)] = 0.0;
+
+    // Pole pairs from the real axis outwards, so Q rises along the cascade. The angle is from the negative real axis;
+    // odd orders have a pole on it, which shifts the pairs by half a step.
+    for (int k = 1; k <= order / 2; ++k) {
+        const double angle = static_cast<double>(2 * k - 1 + order % 2) * Pi / static_cast<double>(2 * order);
+        result.q[static_cast<std::size_t>(result.numSections++)] = 1.0 / (2.0 * constexprCos(angle));
+    }
+
+    return result;
+}
+
+// The order / 2 Butterworth twice. Its first-order section, when it has one, squares to a biquad with a double real
+// pole, which is Q = 0.5.
+constexpr SectionQs makeLinkwitzRiley(int order) noexcept {
+    const auto half = makeButterworth(order / 2);
+    SectionQs result;
+    for (int i = 0; i < half.numSections; ++i) {
+        const double q = half.q[static_cast<std::size_t>(i)];
+        if (q == 0.0) {
+            result.q[static_cast<std::size_t>(result.numSections++)] = 0.5;
+            continue;
+        }
+
+        result.q[static_cast<std::size_t>(result.numSections++)] = q;
+        result.q[static_cast<std::size_t>(result.numSections++)] = q;
+    }
+
+    return result;
+}
+
+constexpr QTable makeTable(bool linkwitzRiley) noexcept {
+    QTable table{};
+    for (int order = 1; order <= CutFilterDesign::MaxOrder; ++order) {
+        if (!linkwitzRiley)
+            table[static_cast<std::size_t>(order)] = makeButterworth(order);
+        else if (order % 2 == 0)
+            table[static_cast<std::size_t>(order)] = makeLinkwitzRiley(order);
+    }
+
+    return table;
+}
+
+constexpr QTable butterworthQs = makeTable(false);
+constexpr QTable linkwitzRileyQs = makeTable(true);
+
+constexpr bool isClose(double value, double expected) noexcept {
+    return (value > expected ? value - expected : expected - value) < 1.0e-12;
+}
+
+constexpr bool sectionCountsFollowOrder() noexcept {
+    for (int order = 1; order <= CutFilterDesign::MaxOrder; ++order) {
+        if (butterworthQs[static_cast<std::size_t>(order)].numSections != (order + 1) / 2)
+            return false;
+        if (order % 2 == 0 && linkwitzRileyQs[static_cast<std::size_t>(order)].numSections != order / 2)
+            return false;
+    }
+
+    return true;
+}
+
+static_assert(sectionCountsFollowOrder(), "A cascade should have ceil(order / 2) sections");
+static_assert(butterworthQs[1].q[0] == 0.0);
+static_assert(isClose(butterworthQs[2].q[0], 0.70710678118654752));
+static_assert(butterworthQs[3].q[0] == 0.0 && isClose(butterworthQs[3].q[1], 1.0));
+static_assert(isClose(butterworthQs[4].q[0], 0.54119610014619698) &&
+              isClose(butterworthQs[4].q[1], 1.30656296487637652));
+static_assert(isClose(linkwitzRileyQs[2].q[0], 0.5));
+static_assert(isClose(linkwitzRileyQs[4].q[0], 0.70710678118654752) &&
+              isClose(linkwitzRileyQs[4].q[1], 0.70710678118654752));
+static_assert(isClose(linkwitzRileyQs[6].q[0], 0.5) && isClose(linkwitzRileyQs[6].q[2], 1.0));
+
+const SectionQs& getSectionQs(util::FilterType type, util::Slope slope) noexcept {
+    const int order = util::getFilterOrder(slope);
+    if (util::isLinkwitzRiley(type))
+        return linkwitzRileyQs[static_cast<std::size_t>(juce::jmin(order + order % 2, CutFilterDesign::MaxOrder))];
+
+    return butterworthQs[static_cast<std::size_t>(order)];
+}
+
+} // namespace
+
+CutFilterDesign::Cascade CutFilterDesign::design(util::FilterType type, util::Slope slope, double sampleRate,
+                                                 float frequencyHz, float resonance) noexcept {
+    jassert(util::isCutFilter(type));
+    const bool highPass = type == util::FilterType::HighPass || type == util::FilterType::HighPassLR;
+    const bool linkwitzRiley = util::isLinkwitzRiley(type);
+    const auto& qs = getSectionQs(type, slope);
+
+    Cascade cascade;
+    cascade.numSections = qs.numSections;
+    for (int i = 0; i < qs.numSections; ++i) {
+        const auto index = static_cast<std::size_t>(i);
+        if (qs.q[index] == 0.0) {
+            const auto firstOrder = highPass ? ArrayCoefficients::makeFirstOrderHighPass(sampleRate, frequencyHz)
+                                             : ArrayCoefficients::makeFirstOrderLowPass(sampleRate, frequencyHz);
+            cascade.sections[index] = {firstOrder[0], firstOrder[1], 0.0f, firstOrder[2], firstOrder[3], 0.0f};
+            cascade.q[index] = 0.5f;
+            continue;
+        }
+
+        auto q = static_cast<float>(qs.q[index]);
+        if (!linkwitzRiley && i == qs.numSections - 1)
+            q *= resonance;
+
+        cascade.sections[index] = highPass ? ArrayCoefficients::makeHighPass(sampleRate, frequencyHz, q)
+                                           : ArrayCoefficients::makeLowPass(sampleRate, frequencyHz, q);
+        cascade.q[index] = q;
+    }
+
+    return cascade;
+}
+
+int CutFilterDesign::getNumSections(util::FilterType type, util::Slope slope) noexcept {
+    return getSectionQs(type, slope).numSections;
+}
+
+} // namespace dsp
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../util/Params.h"
+#include <array>
+
+namespace dsp {
+
+// High- and low-pass cascades with their poles where the filter family puts them. A Butterworth cut of order n is
+// floor(n / 2) biquads at Q = 1 / (2 cos((2k - 1 + n mod 2) pi / 2n)), plus a first-order section when n is odd; a
+// Linkwitz-Riley cut of order 2m is the order-m Butterworth applied twice. Every section is a bilinear transform
+// prewarped to the band frequency, so the corner lands exactly: -3 dB for Butterworth, -6 dB for Linkwitz-Riley.
+// The Q tables are generated at compile time, and a cascade has ceil(order / 2) sections, each designed once.
+class CutFilterDesign final {
+  public:
+    static constexpr int MaxOrder = util::getFilterOrder(util::Slope::Slope96dB);
+    static constexpr int MaxSections = (MaxOrder + 1) / 2;
+
+    // Unnormalised, as JUCE's ArrayCoefficients return them; a first-order section has b2 == a2 == 0.
+    using Coefficients = std::array<float, 6>;
+
+    struct Cascade {
+        std::array<Coefficients, MaxSections> sections{};
+        // Each section's Q, lowest first; 0.5 for a first-order section.
+        std::array<float, MaxSections> q{};
+        int numSections = 0;
+    };
+
+    // `type` must be a cut type. Linkwitz-Riley needs an even order, so odd slopes round up to the next one.
+    // `resonance` scales the Q of the last, highest-Q Butterworth section (1 keeps the response maximally flat);
+    // Linkwitz-Riley ignores it, since anything but flat would break the crossover sum. Allocation-free.
+    [[nodiscard]] static Cascade design(util::FilterType type, util::Slope slope, double sampleRate, float frequencyHz,
+                                        float resonance) noexcept;
+    [[nodiscard]] static int getNumSections(util::FilterType type, util::Slope slope) noexcept;
+};
+
+} // namespace dsp
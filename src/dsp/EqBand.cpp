@@ -1,6 +1,50 @@
 #include "EqBand.h"
 
 namespace dsp {
+EqBand::Settings EqBand::readSettings(const util::Params::BandParams& params, double sampleRate) noexcept {
+    // We expect params pointers to be valid.
+    Settings settings;
+    settings.enabled = isEnabled(params);
+    settings.type = params.getFilterType();
+    settings.gainDb = params.gain->load(std::memory_order_relaxed);
+    settings.slope = params.getSlope();
+
+    const float maxFrequency = static_cast<float>(juce::jmin(sampleRate * 0.495, 20000.0));
+    settings.frequencyHz = juce::jlimit(20.0f, maxFrequency, params.freq->load(std::memory_order_relaxed));
+    settings.q = juce::jlimit(0.1f, 18.0f, params.q->load(std::memory_order_relaxed));
+    return settings;
+}
+
+EqBand::Design EqBand::design(const Settings& settings, double sampleRate) noexcept {
+    Design result;
+    if (util::isCutFilter(settings.type)) {
+        // Q is the cut's resonance relative to the default, which gives the maximally flat response.
+        const auto cascade = CutFilterDesign::design(settings.type, settings.slope, sampleRate, settings.frequencyHz,
+                                                     settings.q / util::Params::defaultQ());
+        result.sections = cascade.sections;
+        result.numSections = cascade.numSections;
+        return result;
+    }
+
+    const float gain = juce::Decibels::decibelsToGain(settings.gainDb);
+    switch (settings.type) {
+    case util::FilterType::Peak:
+        result.sections[0] = ArrayCoefficients::makePeakFilter(sampleRate, settings.frequencyHz, settings.q, gain);
+        break;
+    case util::FilterType::LowShelf:
+        result.sections[0] = ArrayCoefficients::makeLowShelf(sampleRate, settings.frequencyHz, settings.q, gain);
+        break;
+    case util::FilterType::HighShelf:
+        result.sections[0] = ArrayCoefficients::makeHighShelf(sampleRate, settings.frequencyHz, settings.q, gain);
+        break;
+    default:
+        break;
+    }
+
+    result.numSections = 1;
+    return result;
+}
+
 EqBand::EqBand() {}
 
 void EqBand::prepare(const juce::dsp::ProcessSpec& spec) {
@@ -12,6 +56,7 @@ void EqBand::prepare(const juce::dsp::ProcessSpec& spec) {
     smoothedFreq_.reset(sampleRate_, 0.05);
     smoothedGain_.reset(sampleRate_, 0.05);
     smoothedQ_.reset(sampleRate_, 0.05);
+    designedSampleRate_ = 0.0;
 }
 
 void EqBand::reset() {
@@ -22,84 +67,63 @@ void EqBand::reset() {
 void EqBand::updateCoefficients(const util::Params::BandParams& params, double sampleRate, int numSamples) {
     sampleRate_ = sampleRate;
 
-    // We expect params pointers to be valid.
-    const bool isEnabled = params.enabled->load(std::memory_order_relaxed) > 0.5f;
-    enabled_ = isEnabled;
-
-    const auto type = static_cast<util::FilterType>(static_cast<int>(params.type->load(std::memory_order_relaxed)));
-    const float freq = params.freq->load(std::memory_order_relaxed);
-    const float gain = params.gain->load(std::memory_order_relaxed);
-    const float q = params.q->load(std::memory_order_relaxed);
-    const auto slope = static_cast<util::Slope>(static_cast<int>(params.slope->load(std::memory_order_relaxed)));
+    const auto target = readSettings(params, sampleRate_);
+    const bool wasEnabled = enabled_;
+    enabled_ = target.enabled;
 
-    const float maxFrequency = static_cast<float>(juce::jmin(sampleRate_ * 0.495, 20000.0));
-    const float clampedFreq = juce::jlimit(20.0f, maxFrequency, freq);
-    const float clampedQ = juce::jlimit(0.1f, 18.0f, q);
+    if (enabled_ && !wasEnabled) {
+        // Nothing tracked the parameters while the band was off, so there is nothing to glide from.
+        smoothedFreq_.setCurrentAndTargetValue(target.frequencyHz);
+        smoothedGain_.setCurrentAndTargetValue(target.gainDb);
+        smoothedQ_.setCurrentAndTargetValue(target.q);
+        reset();
+    }
 
-    smoothedFreq_.setTargetValue(clampedFreq);
-    smoothedGain_.setTargetValue(gain);
-    smoothedQ_.setTargetValue(clampedQ);
+    smoothedFreq_.setTargetValue(target.frequencyHz);
+    smoothedGain_.setTargetValue(target.gainDb);
+    smoothedQ_.setTargetValue(target.q);
 
     // Advance smoothing by the block length so behavior is block-size independent.
     const int samplesToAdvance = juce::jmax(numSamples, 0);
-    const float currentFreq =
+    auto current = target;
+    current.frequencyHz =
         samplesToAdvance > 0 ? smoothedFreq_.skip(samplesToAdvance) : smoothedFreq_.getCurrentValue();
-    const float currentGain = juce::Decibels::decibelsToGain(samplesToAdvance > 0 ? smoothedGain_.skip(samplesToAdvance)
-                                                                                  : smoothedGain_.getCurrentValue());
-    const float currentQ = samplesToAdvance > 0 ? smoothedQ_.skip(samplesToAdvance) : smoothedQ_.getCurrentValue();
+    current.gainDb = samplesToAdvance > 0 ? smoothedGain_.skip(samplesToAdvance) : smoothedGain_.getCurrentValue();
+    current.q = samplesToAdvance > 0 ? smoothedQ_.skip(samplesToAdvance) : smoothedQ_.getCurrentValue();
 
-    if (!enabled_)
+    if (!enabled_ || (current == designedSettings_ && sampleRate_ == designedSampleRate_))
         return;
 
-    std::array<float, 6> coeffs{1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    applyDesign(design(current, sampleRate_));
+    designedSettings_ = current;
+    designedSampleRate_ = sampleRate_;
+}
 
-    switch (type) {
-    case util::FilterType::Peak:
-        coeffs = ArrayCoefficients::makePeakFilter(sampleRate_, currentFreq, currentQ, currentGain);
-        break;
-    case util::FilterType::LowShelf:
-        coeffs = ArrayCoefficients::makeLowShelf(sampleRate_, currentFreq, currentQ, currentGain);
-        break;
-    case util::FilterType::HighShelf:
-        coeffs = ArrayCoefficients::makeHighShelf(sampleRate_, currentFreq, currentQ, currentGain);
-        break;
-    case util::FilterType::HighPass:
-        coeffs = ArrayCoefficients::makeHighPass(sampleRate_, currentFreq, currentQ);
-        break;
-    case util::FilterType::LowPass:
-        coeffs = ArrayCoefficients::makeLowPass(sampleRate_, currentFreq, currentQ);
-        break;
-    }
+void EqBand::applyRecall(const Settings& settings, const Design& design, double sampleRate) {
+    sampleRate_ = sampleRate;
+    enabled_ = settings.enabled;
+    if (!enabled_)
+        return;
 
-    // For LowPass/HighPass, slope determines how many biquads we cascade
-    // 12dB/oct = 1 biquad, 24dB/oct = 2 biquads, etc.
-    int numFiltersToUse = 1;
-
-    if (type == util::FilterType::LowPass || type == util::FilterType::HighPass) {
-        switch (slope) {
-        case util::Slope::Slope12dB:
-            numFiltersToUse = 1;
-            break;
-        case util::Slope::Slope24dB:
-            numFiltersToUse = 2;
-            break;
-        case util::Slope::Slope36dB:
-            numFiltersToUse = 3;
-            break;
-        case util::Slope::Slope48dB:
-            numFiltersToUse = 4;
-            break;
-        }
-    }
+    smoothedFreq_.setCurrentAndTargetValue(settings.frequencyHz);
+    smoothedGain_.setCurrentAndTargetValue(settings.gainDb);
+    smoothedQ_.setCurrentAndTargetValue(settings.q);
 
-    const std::array<float, 6> bypassCoeffs{1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
+    applyDesign(design);
+    designedSettings_ = settings;
+    designedSampleRate_ = sampleRate_;
+    reset();
+}
 
-    for (int i = 0; i < numFiltersToUse; ++i) {
-        *(filters_[static_cast<std::size_t>(i)].state) = coeffs;
+void EqBand::applyDesign(const Design& design) {
+    for (int i = 0; i < design.numSections; ++i) {
+        auto& filter = filters_[static_cast<std::size_t>(i)];
+        *filter.state = design.sections[static_cast<std::size_t>(i)];
+        // Sections that were not running hold whatever they last saw.
+        if (i >= numSections_)
+            filter.reset();
     }
 
-    for (int i = numFiltersToUse; i < 4; ++i) {
-        *(filters_[static_cast<std::size_t>(i)].state) = bypassCoeffs;
-    }
+    numSections_ = design.numSections;
 }
 } // namespace dsp
@@ -1,36 +1,78 @@
 #pragma once
 
 #include "../util/Params.h"
+#include "CutFilterDesign.h"
 #include <juce_dsp/juce_dsp.h>
 
 namespace dsp {
 class EqBand {
   public:
+    static constexpr int MaxSections = CutFilterDesign::MaxSections;
+
+    // What a band's filters are designed from: its parameters, clamped for the processing rate.
+    struct Settings {
+        bool enabled = false;
+        util::FilterType type = util::FilterType::Peak;
+        float frequencyHz = 1000.0f;
+        float gainDb = 0.0f;
+        float q = 1.0f;
+        util::Slope slope = util::Slope::Slope12dB;
+
+        [[nodiscard]] bool operator==(const Settings& other) const noexcept {
+            return enabled == other.enabled && type == other.type && frequencyHz == other.frequencyHz &&
+                   gainDb == other.gainDb && q == other.q && slope == other.slope;
+        }
+        [[nodiscard]] bool operator!=(const Settings& other) const noexcept { return !(*this == other); }
+    };
+
+    // Biquads (unnormalised, as JUCE's ArrayCoefficients return them) run in order. Only the first `numSections`
+    // are processed: one for a bell or shelf, ceil(order / 2) for a cut.
+    struct Design {
+        std::array<CutFilterDesign::Coefficients, MaxSections> sections{};
+        int numSections = 0;
+    };
+
+    [[nodiscard]] static bool isEnabled(const util::Params::BandParams& params) noexcept {
+        return params.enabled->load(std::memory_order_relaxed) > 0.5f;
+    }
+
+    // The band designer, shared by the audio thread and by recall preparation on other threads. Allocation-free.
+    [[nodiscard]] static Settings readSettings(const util::Params::BandParams& params, double sampleRate) noexcept;
+    [[nodiscard]] static Design design(const Settings& settings, double sampleRate) noexcept;
+
     EqBand();
     ~EqBand() = default;
 
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
 
-    // Call this before processing a block to apply updated parameters.
+    // Call this before processing a block to apply updated parameters. Coefficients are only redesigned while a
+    // smoother is moving or a setting has changed. A band that was disabled starts at its settings, from silence.
     void updateCoefficients(const util::Params::BandParams& params, double sampleRate, int numSamples);
+    // Disabled bands are not updated at all; this just stops process() from running them.
+    void disable() noexcept { enabled_ = false; }
+
+    // Jumps straight to a design prepared elsewhere: smoothers snap to `settings` and the filters start from
+    // silence. Used when a whole state is recalled and the engine crossfades into the result.
+    void applyRecall(const Settings& settings, const Design& design, double sampleRate);
 
     // Bypasses internal processing when the band is disabled.
     template <typename ProcessContext> void process(const ProcessContext& context) {
         if (!enabled_)
             return;
 
-        for (auto& filter : filters_)
-            filter.process(context);
+        for (int i = 0; i < numSections_; ++i)
+            filters_[static_cast<std::size_t>(i)].process(context);
     }
 
   private:
     using Filter = juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>, juce::dsp::IIR::Coefficients<float>>;
     using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
 
-    std::array<Filter, 4> filters_;
+    std::array<Filter, MaxSections> filters_;
 
     bool enabled_ = false;
+    int numSections_ = 0;
 
     // Smoothing interpolators
     juce::LinearSmoothedValue<float> smoothedFreq_{1000.0f};
@@ -38,5 +80,10 @@ class EqBand {
     juce::LinearSmoothedValue<float> smoothedQ_{1.0f};
 
     double sampleRate_ = 44100.0;
+    // What the filters currently hold; designedSampleRate_ is 0 until the first design.
+    Settings designedSettings_;
+    double designedSampleRate_ = 0.0;
+
+    void applyDesign(const Design& design);
 };
 } // namespace dsp
@@ -3,25 +3,123 @@
 namespace dsp {
 void EqEngine::prepare(const juce::dsp::ProcessSpec& spec) {
     sampleRate_ = spec.sampleRate;
+    numChannels_ = static_cast<int>(spec.numChannels);
 
-    for (auto& band : bands_)
-        band.prepare(spec);
+    for (auto& set : bandSets_) {
+        for (auto& band : set.bands)
+            band.prepare(spec);
+    }
+
+    fadeBuffer_.setSize(static_cast<int>(spec.numChannels), static_cast<int>(spec.maximumBlockSize) * 2);
+    fadeSamplesRemaining_ = 0;
 }
 
 void EqEngine::reset() {
-    for (auto& band : bands_)
-        band.reset();
+    for (auto& set : bandSets_) {
+        for (auto& band : set.bands)
+            band.reset();
+    }
+
+    fadeSamplesRemaining_ = 0;
+}
+
+std::size_t EqEngine::getMemoryFootprintBytes() const noexcept {
+    // Each section's ProcessorDuplicator owns one IIR::Filter per channel, which holds a few samples of state.
+    constexpr std::size_t ChannelFilterBytes =
+        sizeof(juce::dsp::IIR::Filter<float>) + sizeof(void*) + 4 * sizeof(float);
+
+    const std::size_t filterBytes = bandSets_.size() * static_cast<std::size_t>(util::Params::MaxBands) *
+                                     EqBand::MaxSections * static_cast<std::size_t>(numChannels_) * ChannelFilterBytes;
+    const std::size_t fadeBytes = sizeof(float) * static_cast<std::size_t>(fadeBuffer_.getNumChannels()) *
+                                  static_cast<std::size_t>(fadeBuffer_.getNumSamples());
+    return sizeof(*this) + filterBytes + fadeBytes;
 }
 
 void EqEngine::updateParameters(const util::Params& params, util::Bank bank, int numSamples, double sampleRate) {
     sampleRate_ = sampleRate;
 
-    for (int i = 0; i < util::Params::NumBands; ++i) {
-        bands_[static_cast<std::size_t>(i)].updateCoefficients(params.getBand(i, bank), sampleRate_, numSamples);
+    if (recall_.acquire() && recall_.getReadBuffer().sampleRate == sampleRate_)
+        startRecall(recall_.getReadBuffer());
+
+    auto& set = bandSets_[activeSet_];
+    set.numActive = 0;
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
+        const auto& bandParams = params.getBand(i, bank);
+        auto& band = set.bands[static_cast<std::size_t>(i)];
+        if (!EqBand::isEnabled(bandParams)) {
+            band.disable();
+            continue;
+        }
+
+        band.updateCoefficients(bandParams, sampleRate_, numSamples);
+        set.active[static_cast<std::size_t>(set.numActive++)] = static_cast<std::uint8_t>(i);
     }
 }
 
 void EqEngine::setSoloBandIndex(int index) noexcept {
     soloBandIndex_ = index;
 }
+
+void EqEngine::prepareRecall(const util::Params& params, util::Bank bank, double sampleRate) {
+    auto& recall = recall_.getWriteBuffer();
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
+        const auto index = static_cast<std::size_t>(i);
+        recall.settings[index] = EqBand::readSettings(params.getBand(i, bank), sampleRate);
+        if (recall.settings[index].enabled)
+            recall.designs[index] = EqBand::design(recall.settings[index], sampleRate);
+    }
+
+    recall.sampleRate = sampleRate;
+    recall_.publish();
+}
+
+void EqEngine::startRecall(const Recall& recall) {
+    // The set that was active fades out frozen; a recall arriving mid-fade restarts the fade from where it was heard.
+    activeSet_ = 1 - activeSet_;
+    auto& set = bandSets_[activeSet_];
+    set.numActive = 0;
+    for (std::size_t i = 0; i < set.bands.size(); ++i) {
+        set.bands[i].applyRecall(recall.settings[i], recall.designs[i], recall.sampleRate);
+        if (recall.settings[i].enabled)
+            set.active[static_cast<std::size_t>(set.numActive++)] = static_cast<std::uint8_t>(i);
+    }
+
+    fadeLengthSamples_ = juce::jmax(1, juce::roundToInt(recall.sampleRate * RecallFadeSeconds));
+    fadeSamplesRemaining_ = fadeLengthSamples_;
+}
+
+void EqEngine::processCrossfade(juce::dsp::AudioBlock<float>& block) {
+    const auto numChannels = block.getNumChannels();
+    const auto numSamples = block.getNumSamples();
+    if (numChannels > static_cast<std::size_t>(fadeBuffer_.getNumChannels()) ||
+        numSamples > static_cast<std::size_t>(fadeBuffer_.getNumSamples())) {
+        // Larger than prepared for: cut over rather than allocate.
+        fadeSamplesRemaining_ = 0;
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        processBands(bandSets_[activeSet_], context);
+        return;
+    }
+
+    auto outgoing =
+        juce::dsp::AudioBlock<float>(fadeBuffer_).getSubsetChannelBlock(0, numChannels).getSubBlock(0, numSamples);
+    outgoing.copyFrom(block);
+    juce::dsp::ProcessContextReplacing<float> outgoingContext(outgoing);
+    juce::dsp::ProcessContextReplacing<float> incomingContext(block);
+    processBands(bandSets_[1 - activeSet_], outgoingContext);
+    processBands(bandSets_[activeSet_], incomingContext);
+
+    // Linear, equal-gain: both sets filter the same input, so their outputs are strongly correlated.
+    const int fadedSoFar = fadeLengthSamples_ - fadeSamplesRemaining_;
+    const float step = 1.0f / static_cast<float>(fadeLengthSamples_);
+    for (std::size_t channel = 0; channel < numChannels; ++channel) {
+        const float* from = outgoing.getChannelPointer(channel);
+        float* to = block.getChannelPointer(channel);
+        for (std::size_t i = 0; i < numSamples; ++i) {
+            const float amount = juce::jmin(1.0f, static_cast<float>(fadedSoFar + static_cast<int>(i) + 1) * step);
+            to[i] = from[i] + amount * (to[i] - from[i]);
+        }
+    }
+
+    fadeSamplesRemaining_ = juce::jmax(0, fadeSamplesRemaining_ - static_cast<int>(numSamples));
+}
 } // namespace dsp
@@ -1,34 +1,89 @@
 #pragma once
 
 #include "../util/Params.h"
+#include "../util/TripleBuffer.h"
 #include "EqBand.h"
+#include <cstdint>
 #include <juce_dsp/juce_dsp.h>
 
 namespace dsp {
 class EqEngine {
   public:
+    // How long a recalled state takes to replace the previous one.
+    static constexpr double RecallFadeSeconds = 0.02;
+
     EqEngine() = default;
     ~EqEngine() = default;
 
+    // Prepares every band of the pool, so enabling one (from automation too) takes effect on the block where it
+    // happens. Disabled bands hold only their idle filter state; they are neither designed nor processed.
     void prepare(const juce::dsp::ProcessSpec& spec);
     void reset();
+    // The bands the last updateParameters() found enabled, i.e. those the next block processes. Audio thread.
+    [[nodiscard]] int getNumActiveBands() const noexcept { return bandSets_[activeSet_].numActive; }
+
+    // Bytes held by the engine, including every band's filter state and the crossfade buffer.
+    [[nodiscard]] std::size_t getMemoryFootprintBytes() const noexcept;
 
     void updateParameters(const util::Params& params, util::Bank bank, int numSamples, double sampleRate);
     void setSoloBandIndex(int index) noexcept;
 
+    // Any thread but the audio thread, after a whole state (session or preset) has been loaded into `params`:
+    // designs every band for `sampleRate` here and hands the result to the audio thread, which switches to it on its
+    // next block by crossfading from the current filters over RecallFadeSeconds, with no smoother sweep. A recall
+    // designed for a rate other than the one the next block runs at is dropped and the bands smooth as usual.
+    // Calls must not overlap: the handoff has a single producer, so callers on several threads need a lock.
+    void prepareRecall(const util::Params& params, util::Bank bank, double sampleRate);
+
     template <typename ProcessContext> void process(const ProcessContext& context) {
-        if (soloBandIndex_ >= 0 && soloBandIndex_ < util::Params::NumBands) {
-            bands_[static_cast<std::size_t>(soloBandIndex_)].process(context);
+        if (fadeSamplesRemaining_ > 0) {
+            processCrossfade(context.getOutputBlock());
             return;
         }
 
-        for (auto& band : bands_)
-            band.process(context);
+        processBands(bandSets_[activeSet_], context);
     }
 
   private:
-    std::array<EqBand, util::Params::NumBands> bands_;
+    // Per-block work is proportional to the enabled bands: `active` lists them in band order and is rebuilt on every
+    // parameter update, so disabled bands are neither designed nor visited while processing.
+    struct BandSet {
+        std::array<EqBand, util::Params::MaxBands> bands;
+        std::array<std::uint8_t, util::Params::MaxBands> active{};
+        int numActive = 0;
+    };
+    static_assert(util::Params::MaxBands <= 256, "Active band indices are stored as bytes");
+
+    struct Recall {
+        std::array<EqBand::Settings, util::Params::MaxBands> settings{};
+        std::array<EqBand::Design, util::Params::MaxBands> designs{};
+        double sampleRate = 0.0;
+    };
+
+    // Two sets so a recall can fade out of one while fading into the other; only bandSets_[activeSet_] follows the
+    // parameters.
+    std::array<BandSet, 2> bandSets_;
+    std::size_t activeSet_ = 0;
+    util::TripleBuffer<Recall> recall_;
+    // Holds the outgoing set's output during a crossfade. Sized for HQ blocks, which are twice the host block.
+    juce::AudioBuffer<float> fadeBuffer_;
+    int fadeLengthSamples_ = 0;
+    int fadeSamplesRemaining_ = 0;
     double sampleRate_ = 44100.0;
     int soloBandIndex_ = -1;
+    int numChannels_ = 0;
+
+    void startRecall(const Recall& recall);
+    void processCrossfade(juce::dsp::AudioBlock<float>& block);
+
+    template <typename ProcessContext> void processBands(BandSet& set, const ProcessContext& context) {
+        if (soloBandIndex_ >= 0 && soloBandIndex_ < util::Params::MaxBands) {
+            set.bands[static_cast<std::size_t>(soloBandIndex_)].process(context);
+            return;
+        }
+
+        for (int i = 0; i < set.numActive; ++i)
+            set.bands[set.active[static_cast<std::size_t>(i)]].process(context);
+    }
 };
 } // namespace dsp
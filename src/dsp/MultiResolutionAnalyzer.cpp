@@ -0,0 +1,196 @@
+#include "MultiResolutionAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dsp {
+namespace {
+
+// Stage s is read for frequencies in [LowerEdge, UpperEdge) times its sample rate. The upper edge stays below the
+// previous decimator's transition band; the lower edge hands over to the next stage while its bins are still coarser.
+constexpr double StageUpperEdge = 0.5;
+constexpr double StageLowerEdge = 0.2;
+
+constexpr float KaiserBeta = 6.0f;
+
+} // namespace
+
+void MultiResolutionAnalyzer::HalfBandDecimator::prepare() noexcept {
+    std::array<float, NumTaps> window{};
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), window.size(),
+                                                             juce::dsp::WindowingFunction<float>::kaiser, false,
+                                                             KaiserBeta);
+
+    double sum = 0.0;
+    for (int n = 0; n < NumTaps; ++n) {
+        const int offset = n - Centre;
+        double tap = 0.0;
+        if (offset == 0) {
+            tap = 0.5;
+        } else if (offset % 2 != 0) {
+            const double x = juce::MathConstants<double>::pi * 0.5 * static_cast<double>(offset);
+            tap = 0.5 * std::sin(x) / x;
+        }
+
+        const double windowed = tap * static_cast<double>(window[static_cast<std::size_t>(n)]);
+        taps_[static_cast<std::size_t>(n)] = static_cast<float>(windowed);
+        sum += windowed;
+    }
+
+    for (auto& tap : taps_)
+        tap = static_cast<float>(static_cast<double>(tap) / sum);
+
+    reset();
+}
+
+void MultiResolutionAnalyzer::HalfBandDecimator::reset() noexcept {
+    delay_.fill(0.0f);
+    writePosition_ = 0;
+    outputPhase_ = false;
+}
+
+bool MultiResolutionAnalyzer::HalfBandDecimator::process(float input, float& output) noexcept {
+    delay_[static_cast<std::size_t>(writePosition_)] = input;
+    delay_[static_cast<std::size_t>(writePosition_ + NumTaps)] = input;
+    writePosition_ = (writePosition_ + 1) % NumTaps;
+
+    outputPhase_ = !outputPhase_;
+    if (!outputPhase_)
+        return false;
+
+    // Oldest sample first; the taps are symmetric so fold each pair around the centre.
+    const float* window = delay_.data() + writePosition_;
+    float sum = taps_[static_cast<std::size_t>(Centre)] * window[Centre];
+    for (int offset = 1; offset <= Centre; offset += 2)
+        sum += taps_[static_cast<std::size_t>(Centre + offset)] * (window[Centre - offset] + window[Centre + offset]);
+
+    output = sum;
+    return true;
+}
+
+void MultiResolutionAnalyzer::prepare(double sampleRate, double minFrequencyHz, double finestBinSpacingHz) {
+    fft_ = std::make_unique<juce::dsp::FFT>(FFTOrder);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window_.data(), window_.size(),
+                                                             juce::dsp::WindowingFunction<float>::hann, true);
+
+    int numStages = 1;
+    while (numStages < MaxStages) {
+        const double nextStageRate = sampleRate / static_cast<double>(1 << numStages);
+        if (nextStageRate / FFTSize < finestBinSpacingHz || nextStageRate * StageUpperEdge <= minFrequencyHz)
+            break;
+        ++numStages;
+    }
+
+    stages_.resize(static_cast<std::size_t>(numStages));
+    for (int s = 0; s < numStages; ++s) {
+        auto& stage = stages_[static_cast<std::size_t>(s)];
+        stage.sampleRate = sampleRate / static_cast<double>(1 << s);
+        stage.decimator.prepare();
+    }
+
+    const double maxFrequencyHz = sampleRate * 0.495;
+    const int numPoints =
+        juce::jmax(2, static_cast<int>(std::ceil(std::log2(maxFrequencyHz / minFrequencyHz) * PointsPerOctave)) + 1);
+    frequenciesHz_.resize(static_cast<std::size_t>(numPoints));
+    pointStages_.resize(static_cast<std::size_t>(numPoints));
+    pointBins_.resize(static_cast<std::size_t>(numPoints));
+
+    const double ratio = maxFrequencyHz / minFrequencyHz;
+    for (int p = 0; p < numPoints; ++p) {
+        const double frequency =
+            minFrequencyHz * std::pow(ratio, static_cast<double>(p) / static_cast<double>(numPoints - 1));
+
+        // Slowest stage whose band still contains the frequency, i.e. the finest bins available for it.
+        int stageIndex = 0;
+        while (stageIndex + 1 < numStages &&
+               frequency < stages_[static_cast<std::size_t>(stageIndex)].sampleRate * StageLowerEdge)
+            ++stageIndex;
+
+        const double binSpacing = stages_[static_cast<std::size_t>(stageIndex)].sampleRate / FFTSize;
+        frequenciesHz_[static_cast<std::size_t>(p)] = static_cast<float>(frequency);
+        pointStages_[static_cast<std::size_t>(p)] = stageIndex;
+        pointBins_[static_cast<std::size_t>(p)] =
+            static_cast<float>(juce::jlimit(0.0, static_cast<double>(FFTSize / 2) - 1.0e-3, frequency / binSpacing));
+    }
+
+    reset();
+}
+
+void MultiResolutionAnalyzer::reset() noexcept {
+    for (auto& stage : stages_) {
+        stage.history.fill(0.0f);
+        stage.writePosition = 0;
+        stage.samplesUntilHop = HopSize;
+        stage.averagePower.fill(0.0f);
+        stage.framesAnalysed = 0;
+        stage.decimator.reset();
+    }
+}
+
+void MultiResolutionAnalyzer::setAveragingFrames(int averagingFrames) noexcept {
+    averagingFrames_ = juce::jmax(1, averagingFrames);
+}
+
+bool MultiResolutionAnalyzer::push(const float* samples, int numSamples) noexcept {
+    bool analysed = false;
+    for (int i = 0; i < numSamples; ++i)
+        analysed = pushSample(samples[i]) || analysed;
+
+    return analysed;
+}
+
+void MultiResolutionAnalyzer::getPowerSpectrum(float* destination) const noexcept {
+    for (std::size_t p = 0; p < frequenciesHz_.size(); ++p) {
+        const auto& power = stages_[static_cast<std::size_t>(pointStages_[p])].averagePower;
+        const float position = pointBins_[p];
+        const auto lower = static_cast<std::size_t>(position);
+        const float fraction = position - static_cast<float>(lower);
+        destination[p] = power[lower] + fraction * (power[lower + 1] - power[lower]);
+    }
+}
+
+bool MultiResolutionAnalyzer::pushSample(float sample) noexcept {
+    bool analysed = false;
+
+    for (auto& stage : stages_) {
+        stage.history[static_cast<std::size_t>(stage.writePosition)] = sample;
+        if (++stage.writePosition == FFTSize)
+            stage.writePosition = 0;
+
+        if (--stage.samplesUntilHop == 0) {
+            stage.samplesUntilHop = HopSize;
+            analyseStage(stage);
+            analysed = true;
+        }
+
+        // Every stage but the last feeds the next one at half its rate.
+        if (&stage == &stages_.back() || !stage.decimator.process(sample, sample))
+            break;
+    }
+
+    return analysed;
+}
+
+void MultiResolutionAnalyzer::analyseStage(Stage& stage) noexcept {
+    const int oldestSamples = FFTSize - stage.writePosition;
+    juce::FloatVectorOperations::multiply(fftBuffer_.data(), stage.history.data() + stage.writePosition,
+                                          window_.data(), oldestSamples);
+    juce::FloatVectorOperations::multiply(fftBuffer_.data() + oldestSamples, stage.history.data(),
+                                          window_.data() + oldestSamples, stage.writePosition);
+
+    fft_->performRealOnlyForwardTransform(fftBuffer_.data(), true);
+
+    const int effectiveFrames = juce::jmin(stage.framesAnalysed + 1, averagingFrames_);
+    const float weight = 1.0f / static_cast<float>(effectiveFrames);
+    constexpr float scale = 1.0f / static_cast<float>((FFTSize / 2) * (FFTSize / 2));
+
+    for (std::size_t bin = 0; bin < stage.averagePower.size(); ++bin) {
+        const float re = fftBuffer_[bin * 2];
+        const float im = fftBuffer_[bin * 2 + 1];
+        const float power = (re * re + im * im) * scale;
+        stage.averagePower[bin] += weight * (power - stage.averagePower[bin]);
+    }
+
+    ++stage.framesAnalysed;
+}
+
+} // namespace dsp
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_dsp/juce_dsp.h>
+#include <memory>
+#include <vector>
+
+namespace dsp {
+
+// Octave-cascaded spectrum analyzer. Stage 0 runs at the input rate; each further stage is fed through a half-band
+// decimator, so every stage can use the same small FFT while the bin spacing halves per octave. The stages are merged
+// into one spectrum on a log-frequency grid of PointsPerOctave points per octave. Each stage contributes the 0.2-0.5 fs
+// part of its spectrum, about 77 bins, or 35-90 bins per octave from its lower to its upper edge. That gives roughly
+// constant relative resolution down to a few Hz at the low end for a fraction of the cost of one large FFT.
+class MultiResolutionAnalyzer {
+  public:
+    static constexpr int FFTOrder = 8;
+    static constexpr int FFTSize = 1 << FFTOrder;
+    static constexpr int HopSize = FFTSize / 2;
+    static constexpr int MaxStages = 10;
+    static constexpr int PointsPerOctave = 48;
+
+    MultiResolutionAnalyzer() = default;
+
+    // Allocates. Adds stages until the lowest one resolves at least `finestBinSpacingHz`.
+    void prepare(double sampleRate, double minFrequencyHz = 20.0, double finestBinSpacingHz = 2.5);
+    void reset() noexcept;
+
+    // Weight of the newest frame in each stage's exponential average is 1 / averagingFrames.
+    void setAveragingFrames(int averagingFrames) noexcept;
+
+    // Returns true if any stage completed a new frame.
+    bool push(const float* samples, int numSamples) noexcept;
+
+    // Linear power per output point, getFrequencies().size() values.
+    void getPowerSpectrum(float* destination) const noexcept;
+    [[nodiscard]] const std::vector<float>& getFrequencies() const noexcept { return frequenciesHz_; }
+    [[nodiscard]] int getNumStages() const noexcept { return static_cast<int>(stages_.size()); }
+
+  private:
+    // Linear-phase half-band lowpass followed by 2:1 decimation. Every other tap of a half-band filter is zero, and
+    // the output is only computed for the samples that are kept.
+    class HalfBandDecimator {
+      public:
+        static constexpr int NumTaps = 39;
+        static constexpr int Centre = NumTaps / 2;
+
+        void prepare() noexcept;
+        void reset() noexcept;
+        // Consumes one input sample; returns true and writes `output` on every second call.
+        bool process(float input, float& output) noexcept;
+
+      private:
+        std::array<float, NumTaps> taps_{};
+        // Each sample is written twice so the newest NumTaps samples are always contiguous.
+        std::array<float, NumTaps * 2> delay_{};
+        int writePosition_ = 0;
+        bool outputPhase_ = false;
+    };
+
+    struct Stage {
+        double sampleRate = 44100.0;
+        std::array<float, FFTSize> history{};
+        int writePosition = 0;
+        int samplesUntilHop = HopSize;
+        std::array<float, FFTSize / 2 + 1> averagePower{};
+        int framesAnalysed = 0;
+        HalfBandDecimator decimator;
+    };
+
+    std::vector<Stage> stages_;
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    std::array<float, FFTSize> window_{};
+    std::array<float, FFTSize * 2> fftBuffer_{};
+    int averagingFrames_ = 4;
+
+    // Per output point: which stage it is read from and its fractional bin position there.
+    std::vector<float> frequenciesHz_;
+    std::vector<int> pointStages_;
+    std::vector<float> pointBins_;
+
+    bool pushSample(float sample) noexcept;
+    void analyseStage(Stage& stage) noexcept;
+};
+
+} // namespace dsp
@@ -0,0 +1,45 @@
+#include "OctaveSmoother.h"
+#include <algorithm>
+#include <cmath>
+
+namespace dsp {
+
+void OctaveSmoother::prepare(const std::vector<float>& frequenciesHz, int octaveFraction) {
+    octaveFraction_ = octaveFraction > 0 ? octaveFraction : 0;
+
+    const auto numPoints = frequenciesHz.size();
+    lower_.resize(numPoints);
+    upper_.resize(numPoints);
+    prefix_.assign(numPoints + 1, 0.0);
+
+    const float halfWidth = octaveFraction_ > 0 ? std::exp2(0.5f / static_cast<float>(octaveFraction_)) : 1.0f;
+    const auto begin = frequenciesHz.begin();
+
+    for (std::size_t p = 0; p < numPoints; ++p) {
+        const float frequency = frequenciesHz[p];
+        auto first = static_cast<int>(std::lower_bound(begin, frequenciesHz.end(), frequency / halfWidth) - begin);
+        auto last = static_cast<int>(std::upper_bound(begin, frequenciesHz.end(), frequency * halfWidth) - begin);
+
+        // DC and exact-boundary points always include themselves.
+        lower_[p] = std::min(first, static_cast<int>(p));
+        upper_[p] = std::max(last, static_cast<int>(p) + 1);
+    }
+}
+
+void OctaveSmoother::process(const float* power, float* destination) noexcept {
+    const auto numPoints = lower_.size();
+
+    double sum = 0.0;
+    for (std::size_t p = 0; p < numPoints; ++p) {
+        sum += static_cast<double>(power[p]);
+        prefix_[p + 1] = sum;
+    }
+
+    for (std::size_t p = 0; p < numPoints; ++p) {
+        const auto first = static_cast<std::size_t>(lower_[p]);
+        const auto last = static_cast<std::size_t>(upper_[p]);
+        destination[p] = static_cast<float>((prefix_[last] - prefix_[first]) / static_cast<double>(last - first));
+    }
+}
+
+} // namespace dsp
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+namespace dsp {
+
+// Fractional-octave smoothing of a power spectrum on an arbitrary ascending frequency axis. Each point becomes the
+// mean power over [f / 2^(1/2N), f * 2^(1/2N)]; with a prefix sum that is two lookups per point whatever the width.
+class OctaveSmoother {
+  public:
+    // Allocates. `octaveFraction` is N in 1/N octave; 0 disables smoothing.
+    void prepare(const std::vector<float>& frequenciesHz, int octaveFraction);
+
+    [[nodiscard]] bool isActive() const noexcept { return octaveFraction_ > 0; }
+    [[nodiscard]] int getOctaveFraction() const noexcept { return octaveFraction_; }
+
+    // `power` and `destination` hold one value per prepared frequency and may not alias.
+    void process(const float* power, float* destination) noexcept;
+
+  private:
+    int octaveFraction_ = 0;
+    // Per point: half-open index range of the points averaged into it.
+    std::vector<int> lower_;
+    std::vector<int> upper_;
+    // Double so that quiet bins next to loud ones do not vanish in the running sum.
+    std::vector<double> prefix_;
+};
+
+} // namespace dsp
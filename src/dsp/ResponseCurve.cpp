@@ -1,6 +1,7 @@
 #include "ResponseCurve.h"
+#include <algorithm>
 #include <cmath>
-#include <complex>
+#include <type_traits>
 #include <juce_dsp/juce_dsp.h>
 
 namespace dsp {
@@ -8,6 +9,10 @@ namespace {
 
 using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
 
+constexpr float MinDisplayDb = -48.0f;
+constexpr float MaxDisplayDb = 24.0f;
+
+// Bells and shelves; cuts come from CutFilterDesign.
 std::array<float, 6> makeCoefficients(util::FilterType type, double sampleRate, float frequencyHz, float q,
                                       float gainLinear) {
     switch (type) {
@@ -17,95 +22,614 @@ std::array<float, 6> makeCoefficients(util::FilterType type, double sampleRate,
         return ArrayCoefficients::makeLowShelf(sampleRate, frequencyHz, q, gainLinear);
     case util::FilterType::HighShelf:
         return ArrayCoefficients::makeHighShelf(sampleRate, frequencyHz, q, gainLinear);
-    case util::FilterType::HighPass:
-        return ArrayCoefficients::makeHighPass(sampleRate, frequencyHz, q);
-    case util::FilterType::LowPass:
-        return ArrayCoefficients::makeLowPass(sampleRate, frequencyHz, q);
+    default:
+        break;
     }
 
     return {1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f};
 }
 
-int slopeStageCount(util::Slope slope) noexcept {
-    switch (slope) {
-    case util::Slope::Slope12dB:
-        return 1;
-    case util::Slope::Slope24dB:
-        return 2;
-    case util::Slope::Slope36dB:
-        return 3;
-    case util::Slope::Slope48dB:
-        return 4;
+// Normalises an unnormalised biquad into a section. Returns false if a0 is degenerate.
+bool setSection(ResponseCurve::Section& section, const std::array<float, 6>& coeffs) noexcept {
+    const double a0 = static_cast<double>(coeffs[3]);
+    if (std::abs(a0) < 1.0e-12)
+        return false;
+
+    section.b0 = static_cast<double>(coeffs[0]) / a0;
+    section.b1 = static_cast<double>(coeffs[1]) / a0;
+    section.b2 = static_cast<double>(coeffs[2]) / a0;
+    section.a1 = static_cast<double>(coeffs[4]) / a0;
+    section.a2 = static_cast<double>(coeffs[5]) / a0;
+    section.stages = 1;
+    return true;
+}
+
+bool isSameSection(const ResponseCurve::Section& a, const ResponseCurve::Section& b) noexcept {
+    return a.b0 == b.b0 && a.b1 == b.b1 && a.b2 == b.b2 && a.a1 == b.a1 && a.a2 == b.a2;
+}
+
+// Mirrors the single 2x stage the processor builds with
+// juce::dsp::Oversampling(..., 1, filterHalfBandPolyphaseIIR, isMaxQuality = true, ...).
+constexpr float UpsamplingTransitionWidth = 0.05f;
+constexpr float UpsamplingStopbandDb = -75.0f;
+constexpr float DownsamplingTransitionWidth = 0.06f;
+constexpr float DownsamplingStopbandDb = -70.0f;
+constexpr int MaxHalfBandSections = 16;
+
+// Polyphase allpass half-band filter H(z) = 0.5 * (direct(z) + delayed(z)), evaluated at the oversampled rate.
+struct HalfBandModel {
+    std::array<ResponseCurve::Section, MaxHalfBandSections> direct{};
+    std::array<ResponseCurve::Section, MaxHalfBandSections> delayed{};
+    int numDirect = 0;
+    int numDelayed = 0;
+};
+
+struct OversamplingModel {
+    HalfBandModel up;
+    HalfBandModel down;
+};
+
+int copySections(const juce::Array<juce::dsp::IIR::Coefficients<float>::Ptr>& path,
+                 std::array<ResponseCurve::Section, MaxHalfBandSections>& destination) {
+    int count = 0;
+    for (const auto& coefficients : path) {
+        if (coefficients == nullptr || count >= MaxHalfBandSections)
+            continue;
+
+        const auto* raw = coefficients->getRawCoefficients();
+        auto& section = destination[static_cast<std::size_t>(count++)];
+        if (coefficients->getFilterOrder() == 1) {
+            section.b0 = static_cast<double>(raw[0]);
+            section.b1 = static_cast<double>(raw[1]);
+            section.b2 = 0.0;
+            section.a1 = static_cast<double>(raw[2]);
+            section.a2 = 0.0;
+        } else {
+            section.b0 = static_cast<double>(raw[0]);
+            section.b1 = static_cast<double>(raw[1]);
+            section.b2 = static_cast<double>(raw[2]);
+            section.a1 = static_cast<double>(raw[3]);
+            section.a2 = static_cast<double>(raw[4]);
+        }
+    }
+
+    return count;
+}
+
+HalfBandModel designHalfBand(float transitionWidth, float stopbandDb) {
+    const auto structure =
+        juce::dsp::FilterDesign<float>::designIIRLowpassHalfBandPolyphaseAllpassMethod(transitionWidth, stopbandDb);
+
+    HalfBandModel model;
+    model.numDirect = copySections(structure.directPath, model.direct);
+    model.numDelayed = copySections(structure.delayedPath, model.delayed);
+    return model;
+}
+
+// Designed once per process; the design itself allocates, evaluation never does.
+const OversamplingModel& getOversamplingModel() {
+    static const OversamplingModel model{designHalfBand(UpsamplingTransitionWidth, UpsamplingStopbandDb),
+                                         designHalfBand(DownsamplingTransitionWidth, DownsamplingStopbandDb)};
+    return model;
+}
+
+// Per-frequency terms of one section at z^-1 = e^(-j omega): numerator N, denominator D and the weighted sums
+// sum(k * c_k * z^-k) whose ratio to N / D gives each polynomial's group delay.
+struct SectionTerms {
+    double numeratorRe;
+    double numeratorIm;
+    double denominatorRe;
+    double denominatorIm;
+    double numeratorDelayRe;
+    double numeratorDelayIm;
+    double denominatorDelayRe;
+    double denominatorDelayIm;
+};
+
+// The delay sums are only filled in when the caller wants group delay.
+template <bool WithGroupDelay>
+inline SectionTerms evaluateSection(const ResponseCurve::Section& section, double cosOmega, double sinOmega,
+                                    double cos2Omega, double sin2Omega) noexcept {
+    SectionTerms terms{};
+    terms.numeratorRe = section.b0 + section.b1 * cosOmega + section.b2 * cos2Omega;
+    terms.numeratorIm = -(section.b1 * sinOmega + section.b2 * sin2Omega);
+    terms.denominatorRe = 1.0 + section.a1 * cosOmega + section.a2 * cos2Omega;
+    terms.denominatorIm = -(section.a1 * sinOmega + section.a2 * sin2Omega);
+    if constexpr (WithGroupDelay) {
+        terms.numeratorDelayRe = section.b1 * cosOmega + 2.0 * section.b2 * cos2Omega;
+        terms.numeratorDelayIm = -(section.b1 * sinOmega + 2.0 * section.b2 * sin2Omega);
+        terms.denominatorDelayRe = section.a1 * cosOmega + 2.0 * section.a2 * cos2Omega;
+        terms.denominatorDelayIm = -(section.a1 * sinOmega + 2.0 * section.a2 * sin2Omega);
     }
+    return terms;
+}
+
+inline double sectionGroupDelay(const SectionTerms& terms) noexcept {
+    const double numeratorPower =
+        std::max(terms.numeratorRe * terms.numeratorRe + terms.numeratorIm * terms.numeratorIm, 1.0e-24);
+    const double denominatorPower =
+        std::max(terms.denominatorRe * terms.denominatorRe + terms.denominatorIm * terms.denominatorIm, 1.0e-24);
+    const double numeratorDelay =
+        (terms.numeratorDelayRe * terms.numeratorRe + terms.numeratorDelayIm * terms.numeratorIm) / numeratorPower;
+    const double denominatorDelay =
+        (terms.denominatorDelayRe * terms.denominatorRe + terms.denominatorDelayIm * terms.denominatorIm) /
+        denominatorPower;
+    return numeratorDelay - denominatorDelay;
+}
+
+// Multiplies (re, im) by N / D of the section `stages` times and returns the section's group delay (0 when not
+// WithGroupDelay).
+template <bool WithGroupDelay>
+inline double accumulateSection(const ResponseCurve::Section& section, double cosOmega, double sinOmega,
+                                double cos2Omega, double sin2Omega, double& re, double& im) noexcept {
+    const auto terms = evaluateSection<WithGroupDelay>(section, cosOmega, sinOmega, cos2Omega, sin2Omega);
+    const double denominatorPower =
+        std::max(terms.denominatorRe * terms.denominatorRe + terms.denominatorIm * terms.denominatorIm, 1.0e-24);
+    const double ratioRe =
+        (terms.numeratorRe * terms.denominatorRe + terms.numeratorIm * terms.denominatorIm) / denominatorPower;
+    const double ratioIm =
+        (terms.numeratorIm * terms.denominatorRe - terms.numeratorRe * terms.denominatorIm) / denominatorPower;
+
+    for (int stage = 0; stage < section.stages; ++stage) {
+        const double nextRe = re * ratioRe - im * ratioIm;
+        im = re * ratioIm + im * ratioRe;
+        re = nextRe;
+    }
+
+    if constexpr (WithGroupDelay)
+        return static_cast<double>(section.stages) * sectionGroupDelay(terms);
+    else
+        return 0.0;
+}
+
+// Complex response and group delay (in oversampled samples) of one half-band filter.
+template <bool WithGroupDelay>
+double accumulateHalfBand(const HalfBandModel& model, double cosOmega, double sinOmega, double cos2Omega,
+                          double sin2Omega, double& re, double& im) noexcept {
+    double directRe = 1.0;
+    double directIm = 0.0;
+    double directDelay = 0.0;
+    for (int i = 0; i < model.numDirect; ++i)
+        directDelay += accumulateSection<WithGroupDelay>(model.direct[static_cast<std::size_t>(i)], cosOmega,
+                                                         sinOmega, cos2Omega, sin2Omega, directRe, directIm);
+
+    double delayedRe = 1.0;
+    double delayedIm = 0.0;
+    double delayedDelay = 0.0;
+    for (int i = 0; i < model.numDelayed; ++i)
+        delayedDelay += accumulateSection<WithGroupDelay>(model.delayed[static_cast<std::size_t>(i)], cosOmega,
+                                                          sinOmega, cos2Omega, sin2Omega, delayedRe, delayedIm);
+
+    // Both paths are allpass, so the half-sum is cos(d/2) * e^(j * mean phase) and its group delay is the mean of
+    // the two path delays wherever the magnitude is non-zero.
+    const double sumRe = 0.5 * (directRe + delayedRe);
+    const double sumIm = 0.5 * (directIm + delayedIm);
+    const double nextRe = re * sumRe - im * sumIm;
+    im = re * sumIm + im * sumRe;
+    re = nextRe;
+
+    return 0.5 * (directDelay + delayedDelay);
+}
 
-    return 1;
+template <bool WithGroupDelay>
+double accumulateOversampling(double cosOmega, double sinOmega, double cos2Omega, double sin2Omega, double& re,
+                              double& im) noexcept {
+    const auto& model = getOversamplingModel();
+    return accumulateHalfBand<WithGroupDelay>(model.up, cosOmega, sinOmega, cos2Omega, sin2Omega, re, im) +
+           accumulateHalfBand<WithGroupDelay>(model.down, cosOmega, sinOmega, cos2Omega, sin2Omega, re, im);
 }
 
-double biquadMagnitude(const std::array<float, 6>& coeffs, double omega) {
-    const std::complex<double> z1 = std::exp(std::complex<double>(0.0, -omega));
-    const std::complex<double> z2 = z1 * z1;
-    const std::complex<double> numerator =
-        static_cast<double>(coeffs[0]) + static_cast<double>(coeffs[1]) * z1 + static_cast<double>(coeffs[2]) * z2;
-    const std::complex<double> denominator =
-        static_cast<double>(coeffs[3]) + static_cast<double>(coeffs[4]) * z1 + static_cast<double>(coeffs[5]) * z2;
-    const double denominatorMagnitude = std::max(std::abs(denominator), 1.0e-12);
-    return std::abs(numerator) / denominatorMagnitude;
+float toDisplayDb(double magnitudeSquared) noexcept {
+    const double db = magnitudeSquared > 0.0 ? 10.0 * std::log10(magnitudeSquared) : MinDisplayDb;
+    return juce::jlimit(MinDisplayDb, MaxDisplayDb, static_cast<float>(db));
+}
+
+// Coarse grid spacing (in workspace points) that every adaptive evaluation starts from. Refinement depth is bounded
+// by log2 of this, so the recursion below never gets deep.
+constexpr std::size_t AdaptiveSeedStride = 16;
+
+float evaluateDisplayDb(const ResponseCurve::Design& design, double cosOmega, double sinOmega, double cos2Omega,
+                        double sin2Omega) noexcept {
+    double magnitudeSquared = design.outputGain * design.outputGain;
+
+    for (int s = 0; s < design.numSections; ++s) {
+        const auto& section = design.sections[static_cast<std::size_t>(s)];
+        const double numeratorRe = section.b0 + section.b1 * cosOmega + section.b2 * cos2Omega;
+        const double numeratorIm = section.b1 * sinOmega + section.b2 * sin2Omega;
+        const double denominatorRe = 1.0 + section.a1 * cosOmega + section.a2 * cos2Omega;
+        const double denominatorIm = section.a1 * sinOmega + section.a2 * sin2Omega;
+
+        const double numerator = numeratorRe * numeratorRe + numeratorIm * numeratorIm;
+        const double denominator = std::max(denominatorRe * denominatorRe + denominatorIm * denominatorIm, 1.0e-24);
+        const double stageMagnitudeSquared = numerator / denominator;
+
+        for (int stage = 0; stage < section.stages; ++stage)
+            magnitudeSquared *= stageMagnitudeSquared;
+    }
+
+    if (design.includesOversampling) {
+        double re = 1.0;
+        double im = 0.0;
+        accumulateOversampling<false>(cosOmega, sinOmega, cos2Omega, sin2Omega, re, im);
+        magnitudeSquared *= re * re + im * im;
+    }
+
+    return toDisplayDb(magnitudeSquared);
 }
 
 } // namespace
 
+void ResponseCurve::Workspace::setFrequencies(const double* frequencies, std::size_t numPoints) {
+    frequencies_.assign(frequencies, frequencies + numPoints);
+    logFrequencies_.resize(numPoints);
+    for (std::size_t i = 0; i < numPoints; ++i)
+        logFrequencies_[i] = std::log(std::max(frequencies_[i], 1.0e-6));
+    evaluated_.resize(numPoints);
+    cosOmega_.resize(numPoints);
+    sinOmega_.resize(numPoints);
+    cos2Omega_.resize(numPoints);
+    sin2Omega_.resize(numPoints);
+    magnitudeSquared_.resize(numPoints);
+    responseRe_.resize(numPoints);
+    responseIm_.resize(numPoints);
+    groupDelay_.resize(numPoints);
+    sampleRate_ = 0.0;
+}
+
+void ResponseCurve::Workspace::updateFrequencyTerms(double sampleRate) noexcept {
+    if (sampleRate == sampleRate_)
+        return;
+
+    sampleRate_ = sampleRate;
+    const double twoPiOverSampleRate = juce::MathConstants<double>::twoPi / sampleRate;
+
+    for (std::size_t i = 0; i < frequencies_.size(); ++i) {
+        const double omega = frequencies_[i] * twoPiOverSampleRate;
+        cosOmega_[i] = std::cos(omega);
+        sinOmega_[i] = std::sin(omega);
+        cos2Omega_[i] = std::cos(2.0 * omega);
+        sin2Omega_[i] = std::sin(2.0 * omega);
+    }
+}
+
 ResponseCurve::State ResponseCurve::capture(const util::Params& params, double sampleRate, util::Bank bank) noexcept {
     State state;
     state.sampleRate = sampleRate;
     state.outputGainDb = params.getOutputGainDb();
+    state.hqEnabled = params.isHQEnabled();
 
     const float maxFrequency = static_cast<float>(juce::jmin(sampleRate * 0.495, 20000.0));
 
-    for (int i = 0; i < util::Params::NumBands; ++i) {
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
         const auto& band = params.getBand(i, bank);
         auto& bandState = state.bands[static_cast<std::size_t>(i)];
         bandState.enabled = band.enabled->load(std::memory_order_relaxed) > 0.5f;
-        bandState.type = static_cast<util::FilterType>(static_cast<int>(band.type->load(std::memory_order_relaxed)));
+        bandState.type = band.getFilterType();
         bandState.frequencyHz = juce::jlimit(20.0f, maxFrequency, band.freq->load(std::memory_order_relaxed));
         bandState.gainDb = juce::jlimit(-24.0f, 24.0f, band.gain->load(std::memory_order_relaxed));
         bandState.q = juce::jlimit(0.1f, 18.0f, band.q->load(std::memory_order_relaxed));
-        bandState.slope = static_cast<util::Slope>(static_cast<int>(band.slope->load(std::memory_order_relaxed)));
+        bandState.slope = band.getSlope();
     }
 
     return state;
 }
 
-std::vector<float> ResponseCurve::computeMagnitudeDb(const State& state, const std::vector<double>& frequencies) {
-    std::vector<float> magnitudeDb(frequencies.size(), 0.0f);
+ResponseCurve::Design ResponseCurve::design(const State& state) noexcept {
+    Design result;
+    result.sampleRate = state.sampleRate;
+    result.processingSampleRate = state.hqEnabled ? state.sampleRate * 2.0 : state.sampleRate;
+    result.includesOversampling = state.hqEnabled;
+    result.outputGain = juce::Decibels::decibelsToGain(static_cast<double>(state.outputGainDb));
 
     if (state.sampleRate <= 0.0)
-        return magnitudeDb;
+        return result;
 
-    const double twoPiOverSampleRate = juce::MathConstants<double>::twoPi / state.sampleRate;
+    for (const auto& band : state.bands) {
+        if (!band.enabled)
+            continue;
+
+        if (!util::isCutFilter(band.type)) {
+            const float gainLinear = juce::Decibels::decibelsToGain(band.gainDb);
+            auto& section = result.sections[static_cast<std::size_t>(result.numSections)];
+            if (!setSection(section, makeCoefficients(band.type, result.processingSampleRate, band.frequencyHz,
+                                                      band.q, gainLinear)))
+                continue;
 
-    for (std::size_t i = 0; i < frequencies.size(); ++i) {
-        const double frequency = frequencies[i];
-        const double omega = frequency * twoPiOverSampleRate;
-        double totalMagnitude = juce::Decibels::decibelsToGain(static_cast<double>(state.outputGainDb));
+            section.frequencyHz = static_cast<double>(band.frequencyHz);
+            section.q = static_cast<double>(band.q);
+            ++result.numSections;
+            continue;
+        }
 
-        for (const auto& band : state.bands) {
-            if (!band.enabled)
+        const auto cascade = CutFilterDesign::design(band.type, band.slope, result.processingSampleRate,
+                                                     band.frequencyHz, band.q / util::Params::defaultQ());
+        const Section* previous = nullptr;
+        for (int i = 0; i < cascade.numSections; ++i) {
+            auto& section = result.sections[static_cast<std::size_t>(result.numSections)];
+            if (!setSection(section, cascade.sections[static_cast<std::size_t>(i)]))
                 continue;
 
-            const float gainLinear = juce::Decibels::decibelsToGain(band.gainDb);
-            const auto coeffs = makeCoefficients(band.type, state.sampleRate, band.frequencyHz, band.q, gainLinear);
+            // Linkwitz-Riley repeats each section; evaluating it once and raising it to a power is cheaper.
+            if (previous != nullptr && isSameSection(*previous, section)) {
+                ++result.sections[static_cast<std::size_t>(result.numSections - 1)].stages;
+                continue;
+            }
+
+            section.frequencyHz = static_cast<double>(band.frequencyHz);
+            section.q = static_cast<double>(cascade.q[static_cast<std::size_t>(i)]);
+            previous = &result.sections[static_cast<std::size_t>(result.numSections++)];
+        }
+    }
+
+    return result;
+}
+
+void ResponseCurve::computeMagnitudeDb(const Design& design, Workspace& workspace, float* destination) noexcept {
+    const std::size_t numPoints = workspace.size();
+    if (destination == nullptr || numPoints == 0)
+        return;
+
+    if (design.sampleRate <= 0.0) {
+        std::fill(destination, destination + numPoints, 0.0f);
+        return;
+    }
 
-            const bool isCutFilter = band.type == util::FilterType::HighPass || band.type == util::FilterType::LowPass;
-            const int stages = isCutFilter ? slopeStageCount(band.slope) : 1;
-            const double stageMagnitude = biquadMagnitude(coeffs, omega);
+    workspace.updateFrequencyTerms(design.processingSampleRate);
 
-            totalMagnitude *= std::pow(stageMagnitude, static_cast<double>(stages));
+    const double* cosOmega = workspace.cosOmega_.data();
+    const double* sinOmega = workspace.sinOmega_.data();
+    const double* cos2Omega = workspace.cos2Omega_.data();
+    const double* sin2Omega = workspace.sin2Omega_.data();
+    double* magnitudeSquared = workspace.magnitudeSquared_.data();
+
+    std::fill(magnitudeSquared, magnitudeSquared + numPoints, design.outputGain * design.outputGain);
+
+    // Band-outer / frequency-inner so each loop body is branch-free and vectorisable.
+    for (int s = 0; s < design.numSections; ++s) {
+        const auto& section = design.sections[static_cast<std::size_t>(s)];
+
+        for (std::size_t i = 0; i < numPoints; ++i) {
+            const double numeratorRe = section.b0 + section.b1 * cosOmega[i] + section.b2 * cos2Omega[i];
+            const double numeratorIm = section.b1 * sinOmega[i] + section.b2 * sin2Omega[i];
+            const double denominatorRe = 1.0 + section.a1 * cosOmega[i] + section.a2 * cos2Omega[i];
+            const double denominatorIm = section.a1 * sinOmega[i] + section.a2 * sin2Omega[i];
+
+            const double numerator = numeratorRe * numeratorRe + numeratorIm * numeratorIm;
+            const double denominator = std::max(denominatorRe * denominatorRe + denominatorIm * denominatorIm, 1.0e-24);
+            const double stageMagnitudeSquared = numerator / denominator;
+
+            double magnitude = stageMagnitudeSquared;
+            for (int stage = 1; stage < section.stages; ++stage)
+                magnitude *= stageMagnitudeSquared;
+
+            magnitudeSquared[i] *= magnitude;
+        }
+    }
+
+    if (design.includesOversampling) {
+        for (std::size_t i = 0; i < numPoints; ++i) {
+            double re = 1.0;
+            double im = 0.0;
+            accumulateOversampling<false>(cosOmega[i], sinOmega[i], cos2Omega[i], sin2Omega[i], re, im);
+            magnitudeSquared[i] *= re * re + im * im;
+        }
+    }
+
+    for (std::size_t i = 0; i < numPoints; ++i)
+        destination[i] = toDisplayDb(magnitudeSquared[i]);
+}
+
+void ResponseCurve::computeMagnitudeDb(const State& state, Workspace& workspace, float* destination) noexcept {
+    computeMagnitudeDb(design(state), workspace, destination);
+}
+
+std::size_t ResponseCurve::computeMagnitudeDbAdaptive(const Design& design, Workspace& workspace, float* destination,
+                                                      float toleranceDb) noexcept {
+    const std::size_t numPoints = workspace.size();
+    if (destination == nullptr || numPoints == 0)
+        return 0;
+
+    if (design.sampleRate <= 0.0) {
+        std::fill(destination, destination + numPoints, 0.0f);
+        return 0;
+    }
+
+    workspace.updateFrequencyTerms(design.processingSampleRate);
+
+    const double* frequencies = workspace.frequencies_.data();
+    const double* logFrequencies = workspace.logFrequencies_.data();
+    unsigned char* evaluated = workspace.evaluated_.data();
+    std::fill(evaluated, evaluated + numPoints, static_cast<unsigned char>(0));
+
+    std::size_t evaluationCount = 0;
+    auto evaluate = [&](std::size_t i) {
+        if (evaluated[i] != 0)
+            return;
+
+        destination[i] = evaluateDisplayDb(design, workspace.cosOmega_[i], workspace.sinOmega_[i],
+                                           workspace.cos2Omega_[i], workspace.sin2Omega_[i]);
+        evaluated[i] = 1;
+        ++evaluationCount;
+    };
+
+    auto interpolate = [&](std::size_t lower, std::size_t upper, std::size_t i) {
+        const double span = logFrequencies[upper] - logFrequencies[lower];
+        const double t = span > 0.0 ? (logFrequencies[i] - logFrequencies[lower]) / span : 0.0;
+        return destination[lower] + static_cast<float>(t) * (destination[upper] - destination[lower]);
+    };
+
+    // Coarse grid plus both ends.
+    for (std::size_t i = 0; i < numPoints; i += AdaptiveSeedStride)
+        evaluate(i);
+    evaluate(numPoints - 1);
+
+    // Narrow features can fall entirely between grid points, so seed each band's centre/corner and the edges of its
+    // bandwidth explicitly.
+    auto seedFrequency = [&](double frequencyHz) {
+        if (frequencyHz <= frequencies[0] || frequencyHz >= frequencies[numPoints - 1])
+            return;
+
+        const auto upper = static_cast<std::size_t>(
+            std::lower_bound(frequencies, frequencies + numPoints, frequencyHz) - frequencies);
+        evaluate(upper - 1);
+        evaluate(upper);
+    };
+
+    for (int s = 0; s < design.numSections; ++s) {
+        const auto& section = design.sections[static_cast<std::size_t>(s)];
+        const double halfBandwidth = 0.5 / std::max(section.q, 0.025);
+        seedFrequency(section.frequencyHz);
+        seedFrequency(section.frequencyHz / (1.0 + halfBandwidth));
+        seedFrequency(section.frequencyHz * (1.0 + halfBandwidth));
+    }
+
+    // Bisect any span whose midpoint deviates from the straight line by more than the tolerance.
+    auto refine = [&](auto& self, std::size_t lower, std::size_t upper) -> void {
+        if (upper - lower < 2)
+            return;
+
+        const std::size_t middle = lower + (upper - lower) / 2;
+        evaluate(middle);
+
+        if (std::abs(destination[middle] - interpolate(lower, upper, middle)) > toleranceDb) {
+            self(self, lower, middle);
+            self(self, middle, upper);
+        }
+    };
+
+    std::size_t lower = 0;
+    for (std::size_t i = 1; i < numPoints; ++i) {
+        if (evaluated[i] == 0)
+            continue;
+
+        refine(refine, lower, i);
+        lower = i;
+    }
+
+    // Fill the remaining points from their evaluated neighbours.
+    lower = 0;
+    for (std::size_t i = 1; i < numPoints; ++i) {
+        if (evaluated[i] == 0)
+            continue;
+
+        for (std::size_t j = lower + 1; j < i; ++j)
+            destination[j] = interpolate(lower, i, j);
+
+        lower = i;
+    }
+
+    return evaluationCount;
+}
+
+std::size_t ResponseCurve::computeMagnitudeDbAdaptive(const State& state, Workspace& workspace, float* destination,
+                                                      float toleranceDb) noexcept {
+    return computeMagnitudeDbAdaptive(design(state), workspace, destination, toleranceDb);
+}
+
+void ResponseCurve::computeResponse(const Design& design, Workspace& workspace, float* magnitudeDb,
+                                    float* phaseRadians, float* groupDelaySamples) noexcept {
+    const std::size_t numPoints = workspace.size();
+    if (numPoints == 0)
+        return;
+
+    if (design.sampleRate <= 0.0) {
+        if (magnitudeDb != nullptr)
+            std::fill(magnitudeDb, magnitudeDb + numPoints, 0.0f);
+        if (phaseRadians != nullptr)
+            std::fill(phaseRadians, phaseRadians + numPoints, 0.0f);
+        if (groupDelaySamples != nullptr)
+            std::fill(groupDelaySamples, groupDelaySamples + numPoints, 0.0f);
+        return;
+    }
+
+    workspace.updateFrequencyTerms(design.processingSampleRate);
+
+    const double* cosOmega = workspace.cosOmega_.data();
+    const double* sinOmega = workspace.sinOmega_.data();
+    const double* cos2Omega = workspace.cos2Omega_.data();
+    const double* sin2Omega = workspace.sin2Omega_.data();
+    double* responseRe = workspace.responseRe_.data();
+    double* responseIm = workspace.responseIm_.data();
+    double* groupDelay = workspace.groupDelay_.data();
+
+    // The running complex product carries magnitude and phase together, so phase costs one complex multiply per
+    // section on top of the terms magnitude already needs, plus a single atan2 per point at the end. Group delay
+    // terms are only evaluated when asked for.
+    std::fill(responseRe, responseRe + numPoints, design.outputGain);
+    std::fill(responseIm, responseIm + numPoints, 0.0);
+
+    auto accumulate = [&](auto withGroupDelay) {
+        constexpr bool WithGroupDelay = decltype(withGroupDelay)::value;
+        if constexpr (WithGroupDelay)
+            std::fill(groupDelay, groupDelay + numPoints, 0.0);
+
+        for (int s = 0; s < design.numSections; ++s) {
+            const auto& section = design.sections[static_cast<std::size_t>(s)];
+
+            for (std::size_t i = 0; i < numPoints; ++i) {
+                const double delay = accumulateSection<WithGroupDelay>(section, cosOmega[i], sinOmega[i], cos2Omega[i],
+                                                                       sin2Omega[i], responseRe[i], responseIm[i]);
+                if constexpr (WithGroupDelay)
+                    groupDelay[i] += delay;
+            }
+        }
+
+        if (design.includesOversampling) {
+            for (std::size_t i = 0; i < numPoints; ++i) {
+                const double delay = accumulateOversampling<WithGroupDelay>(cosOmega[i], sinOmega[i], cos2Omega[i],
+                                                                            sin2Omega[i], responseRe[i], responseIm[i]);
+                if constexpr (WithGroupDelay)
+                    groupDelay[i] += delay;
+            }
         }
+    };
 
-        const float db = juce::Decibels::gainToDecibels(static_cast<float>(totalMagnitude), -48.0f);
-        magnitudeDb[i] = juce::jlimit(-48.0f, 24.0f, db);
+    if (groupDelaySamples != nullptr)
+        accumulate(std::true_type{});
+    else
+        accumulate(std::false_type{});
+
+    const double samplesPerProcessingSample = design.sampleRate / design.processingSampleRate;
+
+    for (std::size_t i = 0; i < numPoints; ++i) {
+        if (magnitudeDb != nullptr)
+            magnitudeDb[i] = toDisplayDb(responseRe[i] * responseRe[i] + responseIm[i] * responseIm[i]);
+        if (phaseRadians != nullptr)
+            phaseRadians[i] = static_cast<float>(std::atan2(responseIm[i], responseRe[i]));
+        if (groupDelaySamples != nullptr)
+            groupDelaySamples[i] = static_cast<float>(groupDelay[i] * samplesPerProcessingSample);
     }
+}
+
+double ResponseCurve::computeGroupDelaySamples(const Design& design, double frequencyHz) noexcept {
+    if (design.sampleRate <= 0.0 || design.processingSampleRate <= 0.0)
+        return 0.0;
 
+    const double omega = juce::MathConstants<double>::twoPi * frequencyHz / design.processingSampleRate;
+    const double cosOmega = std::cos(omega);
+    const double sinOmega = std::sin(omega);
+    const double cos2Omega = std::cos(2.0 * omega);
+    const double sin2Omega = std::sin(2.0 * omega);
+
+    double re = 1.0;
+    double im = 0.0;
+    double groupDelay = 0.0;
+    for (int s = 0; s < design.numSections; ++s)
+        groupDelay += accumulateSection<true>(design.sections[static_cast<std::size_t>(s)], cosOmega, sinOmega,
+                                              cos2Omega, sin2Omega, re, im);
+
+    if (design.includesOversampling)
+        groupDelay += accumulateOversampling<true>(cosOmega, sinOmega, cos2Omega, sin2Omega, re, im);
+
+    return groupDelay * design.sampleRate / design.processingSampleRate;
+}
+
+std::vector<float> ResponseCurve::computeMagnitudeDb(const State& state, const std::vector<double>& frequencies) {
+    Workspace workspace;
+    workspace.setFrequencies(frequencies.data(), frequencies.size());
+
+    std::vector<float> magnitudeDb(frequencies.size(), 0.0f);
+    computeMagnitudeDb(state, workspace, magnitudeDb.data());
     return magnitudeDb;
 }
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "../util/Params.h"
+#include "CutFilterDesign.h"
+#include <array>
 #include <juce_core/juce_core.h>
 #include <vector>
 
@@ -15,16 +17,103 @@ class ResponseCurve {
         float gainDb = 0.0f;
         float q = 1.0f;
         util::Slope slope = util::Slope::Slope12dB;
+
+        [[nodiscard]] bool operator==(const BandState& other) const noexcept {
+            return enabled == other.enabled && type == other.type && frequencyHz == other.frequencyHz &&
+                   gainDb == other.gainDb && q == other.q && slope == other.slope;
+        }
+        [[nodiscard]] bool operator!=(const BandState& other) const noexcept { return !(*this == other); }
     };
 
     struct State {
-        std::array<BandState, util::Params::NumBands> bands{};
+        std::array<BandState, util::Params::MaxBands> bands{};
         float outputGainDb = 0.0f;
         double sampleRate = 44100.0;
+        bool hqEnabled = false;
+
+        [[nodiscard]] bool operator==(const State& other) const noexcept {
+            return bands == other.bands && outputGainDb == other.outputGainDb && sampleRate == other.sampleRate &&
+                   hqEnabled == other.hqEnabled;
+        }
+        [[nodiscard]] bool operator!=(const State& other) const noexcept { return !(*this == other); }
+    };
+
+    // Biquad normalised to a0 == 1, applied `stages` times; a cut contributes one section per distinct biquad of its
+    // cascade (a first-order section has b2 == a2 == 0).
+    struct Section {
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+        int stages = 1;
+        // Band centre/corner and Q the section was designed from; used to seed adaptive sampling.
+        double frequencyHz = 0.0;
+        double q = 0.7071;
+    };
+
+    // Coefficients for every enabled band of a State, designed once and shared by all evaluated frequencies.
+    // In HQ mode the bands run (and are designed) at the oversampled rate and the half-band resampling filters
+    // become part of the response.
+    struct Design {
+        std::array<Section, util::Params::MaxBands * CutFilterDesign::MaxSections> sections{};
+        int numSections = 0;
+        double outputGain = 1.0;
+        double sampleRate = 44100.0;
+        double processingSampleRate = 44100.0;
+        bool includesOversampling = false;
+    };
+
+    // Caller-owned evaluation scratch. setFrequencies() is the only call that may allocate; evaluating into a
+    // caller-provided buffer afterwards is allocation-free.
+    class Workspace {
+      public:
+        void setFrequencies(const double* frequencies, std::size_t numPoints);
+        [[nodiscard]] std::size_t size() const noexcept { return frequencies_.size(); }
+        [[nodiscard]] const double* getFrequencies() const noexcept { return frequencies_.data(); }
+
+      private:
+        friend class ResponseCurve;
+
+        void updateFrequencyTerms(double sampleRate) noexcept;
+
+        std::vector<double> frequencies_;
+        std::vector<double> logFrequencies_;
+        std::vector<unsigned char> evaluated_;
+        std::vector<double> cosOmega_;
+        std::vector<double> sinOmega_;
+        std::vector<double> cos2Omega_;
+        std::vector<double> sin2Omega_;
+        std::vector<double> magnitudeSquared_;
+        std::vector<double> responseRe_;
+        std::vector<double> responseIm_;
+        std::vector<double> groupDelay_;
+        double sampleRate_ = 0.0;
     };
 
     [[nodiscard]] static State capture(const util::Params& params, double sampleRate,
                                        util::Bank bank = util::Bank::A) noexcept;
+    [[nodiscard]] static Design design(const State& state) noexcept;
+
+    // Writes workspace.size() values into destination.
+    static void computeMagnitudeDb(const Design& design, Workspace& workspace, float* destination) noexcept;
+    static void computeMagnitudeDb(const State& state, Workspace& workspace, float* destination) noexcept;
+
+    // Single pass over the shared section terms. Any destination may be nullptr. Phase is wrapped to [-pi, pi];
+    // group delay is in samples at the host sample rate, so it can be compared directly against reported latency.
+    static void computeResponse(const Design& design, Workspace& workspace, float* magnitudeDb, float* phaseRadians,
+                                float* groupDelaySamples) noexcept;
+    [[nodiscard]] static double computeGroupDelaySamples(const Design& design, double frequencyHz) noexcept;
+
+    // Evaluates a subset of the workspace frequencies (a coarse grid, every band's centre and edges, then midpoints
+    // wherever linear interpolation in log frequency is off by more than toleranceDb) and interpolates the rest.
+    // Expects ascending frequencies. Returns how many frequencies were actually evaluated.
+    static constexpr float DefaultAdaptiveToleranceDb = 0.05f;
+    static std::size_t computeMagnitudeDbAdaptive(const Design& design, Workspace& workspace, float* destination,
+                                                  float toleranceDb = DefaultAdaptiveToleranceDb) noexcept;
+    static std::size_t computeMagnitudeDbAdaptive(const State& state, Workspace& workspace, float* destination,
+                                                  float toleranceDb = DefaultAdaptiveToleranceDb) noexcept;
+
     [[nodiscard]] static std::vector<float> computeMagnitudeDb(const State& state,
                                                                const std::vector<double>& frequencies);
 };
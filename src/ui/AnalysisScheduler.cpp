@@ -0,0 +1,91 @@
+#include "AnalysisScheduler.h"
+#include <algorithm>
+
+namespace ui {
+namespace {
+
+int chooseThreadCount() {
+    // A couple of threads keep up with dozens of analyzers; more would only compete with the host's own workers.
+    return juce::jlimit(1, 3, juce::SystemStats::getNumCpus() / 2);
+}
+
+} // namespace
+
+AnalysisScheduler::AnalysisScheduler() : pool_(chooseThreadCount(), 0, juce::Thread::Priority::low) {}
+
+AnalysisScheduler::~AnalysisScheduler() {
+    {
+        const juce::ScopedLock lock(lock_);
+        jassert(pending_.empty());
+        pending_.clear();
+    }
+
+    pool_.removeAllJobs(true, 2000);
+}
+
+void AnalysisScheduler::requestAnalysis(Client& client) {
+    const juce::ScopedLock lock(lock_);
+
+    if (client.running_) {
+        client.rerunRequested_ = true;
+        return;
+    }
+
+    if (!client.queued_)
+        enqueueLocked(client);
+}
+
+void AnalysisScheduler::cancel(Client& client) {
+    while (true) {
+        {
+            const juce::ScopedLock lock(lock_);
+            pending_.erase(std::remove(pending_.begin(), pending_.end(), &client), pending_.end());
+            client.queued_ = false;
+            client.rerunRequested_ = false;
+
+            if (!client.running_)
+                return;
+        }
+
+        // A signal left over from an earlier run only costs one more pass round the loop.
+        client.finished_.wait();
+    }
+}
+
+void AnalysisScheduler::enqueueLocked(Client& client) {
+    client.queued_ = true;
+    pending_.push_back(&client);
+
+    // One job per queued client, but the job takes whoever is at the front rather than a fixed client, so service
+    // order follows pending_ no matter how the pool orders its jobs. A job left over after cancel() just finds the
+    // queue empty.
+    pool_.addJob([this] { runNextClient(); });
+}
+
+void AnalysisScheduler::runNextClient() {
+    Client* client = nullptr;
+    {
+        const juce::ScopedLock lock(lock_);
+        if (pending_.empty())
+            return;
+
+        client = pending_.front();
+        pending_.pop_front();
+        client->queued_ = false;
+        client->running_ = true;
+    }
+
+    client->runAnalysis();
+
+    const juce::ScopedLock lock(lock_);
+    client->running_ = false;
+    // Inside the lock, so cancel() cannot return, and the client go away, before this call is done with it.
+    client->finished_.signal();
+
+    if (client->rerunRequested_) {
+        client->rerunRequested_ = false;
+        enqueueLocked(*client);
+    }
+}
+
+} // namespace ui
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <deque>
+#include <juce_core/juce_core.h>
+
+namespace ui {
+
+// Process-wide pool that runs analyzer work for every open editor. Hold it through
+// juce::SharedResourcePointer<AnalysisScheduler> so all plugin instances in the process share one small set of
+// low-priority threads instead of each doing FFTs on the message thread.
+//
+// Requests are coalesced per client: asking again while a client is still queued is a no-op, and asking while it
+// is running schedules exactly one more run. Clients are served in request order, so a busy instance cannot starve
+// the others, and a client never runs concurrently with itself.
+class AnalysisScheduler final {
+  public:
+    class Client {
+      public:
+        virtual ~Client() = default;
+
+        // Called on a pool thread.
+        virtual void runAnalysis() = 0;
+
+      private:
+        friend class AnalysisScheduler;
+
+        // Guarded by the scheduler's lock.
+        bool queued_ = false;
+        bool running_ = false;
+        bool rerunRequested_ = false;
+        // Signalled, under the scheduler's lock, each time a run finishes.
+        juce::WaitableEvent finished_;
+    };
+
+    AnalysisScheduler();
+    ~AnalysisScheduler();
+
+    void requestAnalysis(Client& client);
+
+    // Drops any pending request and waits for a running one to finish. Call before destroying the client.
+    void cancel(Client& client);
+
+    [[nodiscard]] int getNumThreads() const noexcept { return pool_.getNumThreads(); }
+
+  private:
+    juce::ThreadPool pool_;
+    juce::CriticalSection lock_;
+    std::deque<Client*> pending_;
+
+    void enqueueLocked(Client& client);
+    void runNextClient();
+
+    JUCE_DECLARE_NON_COPYABLE(AnalysisScheduler)
+};
+
+} // namespace ui
@@ -1,5 +1,6 @@
 #include "EqPlotComponent.h"
 #include <cmath>
+#include <utility>
 
 namespace ui {
 namespace {
@@ -7,22 +8,48 @@ namespace {
 constexpr float MinFrequencyHz = 20.0f;
 constexpr float MinDb = -24.0f;
 constexpr float MaxDb = 24.0f;
+// Maximum deviation of the drawn response curves from the evaluated ones, in logical pixels.
+constexpr float ResponsePathTolerance = 0.25f;
 
 } // namespace
 
 EqPlotComponent::EqPlotComponent(util::Params& params, SpectrumAnalyzer& spectrumAnalyzer)
     : params_(params), spectrumAnalyzer_(spectrumAnalyzer) {
-    startTimerHz(45);
+    for (auto* parameter : params_.apvts.processor.getParameters()) {
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            params_.apvts.addParameterListener(withID->paramID, this);
+    }
+
     rebuildFrequencyAxis();
 }
 
+EqPlotComponent::~EqPlotComponent() {
+    for (auto* parameter : params_.apvts.processor.getParameters()) {
+        if (auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter))
+            params_.apvts.removeParameterListener(withID->paramID, this);
+    }
+}
+
 void EqPlotComponent::setSampleRate(double sampleRate) {
-    sampleRate_ = sampleRate;
+    // Hosts report 0 before prepareToPlay; keep drawing against a sensible default until then.
+    const double effectiveSampleRate = sampleRate > 1.0 ? sampleRate : 44100.0;
+    if (effectiveSampleRate == sampleRate_)
+        return;
+
+    sampleRate_ = effectiveSampleRate;
+    rebuildFrequencyAxis();
+    gridLayerDirty_ = true;
+    parametersChanged_ = true;
+    repaint();
 }
 
 void EqPlotComponent::setSelectedBand(int index) {
-    selectedBandIndex_ = (index >= 0 && index < util::Params::NumBands) ? index : -1;
-    repaint();
+    const int nextIndex = (index >= 0 && index < util::Params::MaxBands) ? index : -1;
+    if (nextIndex == selectedBandIndex_)
+        return;
+
+    selectedBandIndex_ = nextIndex;
+    invalidateCurveLayer();
 }
 
 void EqPlotComponent::setBandSelectionCallback(std::function<void(int)> callback) {
@@ -34,59 +61,55 @@ void EqPlotComponent::setBandSoloCallback(std::function<void(int, bool)> callbac
 }
 
 void EqPlotComponent::paint(juce::Graphics& g) {
-    const auto bounds = getPlotBounds();
-    g.setColour(juce::Colour::fromRGB(30, 33, 37));
-    g.fillRoundedRectangle(bounds, 6.0f);
+    if (getWidth() <= 0 || getHeight() <= 0)
+        return;
 
-    drawGrid(g, bounds);
-    g.saveState();
-    g.reduceClipRegion(bounds.toNearestInt());
-    spectrumAnalyzer_.draw(g);
+    const double paintStartMs = juce::Time::getMillisecondCounterHiRes();
 
-    if (!secondaryResponsePath_.isEmpty()) {
-        g.setColour(juce::Colour::fromRGB(154, 179, 255).withAlpha(0.78f));
-        g.strokePath(secondaryResponsePath_, juce::PathStrokeType(1.75f, juce::PathStrokeType::curved));
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (scale != layerScale_) {
+        layerScale_ = scale;
+        gridLayerDirty_ = true;
+        curveLayerDirty_ = true;
     }
 
-    g.setColour(juce::Colour::fromRGB(118, 227, 255));
-    g.strokePath(primaryResponsePath_, juce::PathStrokeType(2.2f, juce::PathStrokeType::curved));
-    g.restoreState();
-    drawResponseLegend(g, bounds);
-
-    for (int i = 0; i < util::Params::NumBands; ++i) {
-        const bool enabled = getBandFieldValueForDisplay(i, BandField::Enabled) > 0.5f;
+    if (gridLayerDirty_)
+        renderGridLayer();
+    if (curveLayerDirty_)
+        renderCurveLayer();
 
-        const float radius = (i == selectedBandIndex_) ? 11.0f : 9.0f;
-        const auto node = nodePositions_[static_cast<std::size_t>(i)];
-        const auto nodeBounds = juce::Rectangle<float>(radius * 2.0f, radius * 2.0f).withCentre(node);
-
-        g.setColour(enabled ? juce::Colour::fromRGB(255, 185, 67).withAlpha(0.9f)
-                            : juce::Colour::fromRGB(120, 120, 120).withAlpha(0.8f));
-        g.fillEllipse(nodeBounds);
-
-        g.setColour(juce::Colour::fromRGB(28, 30, 34));
-        g.fillEllipse(nodeBounds.reduced(2.2f));
+    const auto area = getLocalBounds().toFloat();
+    g.drawImage(gridImage_, area);
+    spectrumAnalyzer_.draw(g);
+    g.drawImage(curveImage_, area);
 
-        g.setColour(enabled ? juce::Colour::fromRGB(255, 185, 67) : juce::Colour::fromRGB(100, 100, 100));
-        g.setFont(12.5f);
-        g.drawFittedText(juce::String(i + 1), nodeBounds.toNearestInt(), juce::Justification::centred, 1);
-    }
+    paintCostMs_ += juce::Time::getMillisecondCounterHiRes() - paintStartMs;
 }
 
 void EqPlotComponent::resized() {
     rebuildFrequencyAxis();
-    rebuildPaths();
+    gridLayerDirty_ = true;
+    curveLayerDirty_ = true;
+    refreshResponse();
 }
 
 void EqPlotComponent::mouseDown(const juce::MouseEvent& event) {
+    if (event.mods.isPopupMenu()) {
+        showAnalyzerMenu();
+        return;
+    }
+
     // Ensure node hit-testing uses the latest parameter-derived positions.
-    rebuildPaths();
+    if (parametersChanged_.exchange(false))
+        refreshResponse();
 
     pendingDragBandIndex_ = -1;
     draggingBandIndex_ = -1;
+    endGesture();
     const int bestIndex = findNearestNode(event.position, 16.0f);
 
     if (bestIndex >= 0) {
+        gestureWriter_.begin();
         selectedBandIndex_ = bestIndex;
         pendingDragBandIndex_ = bestIndex;
         dragStartPosition_ = event.position;
@@ -113,13 +136,17 @@ void EqPlotComponent::mouseDown(const juce::MouseEvent& event) {
         draggingBandIndex_ = -1;
     }
 
-    repaint();
+    invalidateCurveLayer();
 }
 
 void EqPlotComponent::mouseDoubleClick(const juce::MouseEvent& event) {
     const int bandIndex = findNearestNode(event.position, 18.0f);
-    if (bandIndex < 0)
+    if (bandIndex < 0) {
+        const auto plotBounds = getPlotBounds();
+        if (plotBounds.contains(event.position))
+            addBand(xToFrequency(event.position.x, plotBounds), yToDb(event.position.y, plotBounds));
         return;
+    }
 
     selectedBandIndex_ = bandIndex;
     pendingDragBandIndex_ = -1;
@@ -128,7 +155,7 @@ void EqPlotComponent::mouseDoubleClick(const juce::MouseEvent& event) {
         bandSelectionCallback_(bandIndex);
 
     resetBandToDefaults(bandIndex);
-    repaint();
+    invalidateCurveLayer();
 }
 
 void EqPlotComponent::mouseDrag(const juce::MouseEvent& event) {
@@ -184,22 +211,54 @@ void EqPlotComponent::mouseUp(const juce::MouseEvent&) {
     soloActive_ = false;
     pendingDragBandIndex_ = -1;
     draggingBandIndex_ = -1;
+    endGesture();
 }
 
 void EqPlotComponent::mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) {
-    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::NumBands)
+    if (selectedBandIndex_ < 0 || selectedBandIndex_ >= util::Params::MaxBands)
         return;
 
     const float currentQ = getBandFieldValueForDisplay(selectedBandIndex_, BandField::Q);
     const float scaledDelta = static_cast<float>(wheel.deltaY) * 0.35f;
     const float nextQ = juce::jlimit(0.1f, 18.0f, currentQ * std::exp(scaledDelta));
+    if (!gestureWriter_.isActive()) {
+        gestureWriter_.begin();
+        wheelGestureActive_ = true;
+    }
+    lastWheelMs_ = juce::Time::getMillisecondCounterHiRes();
     setBandFieldValueForEditTarget(selectedBandIndex_ + 1, BandField::Q, nextQ);
 }
 
-void EqPlotComponent::timerCallback() {
-    setSampleRate(sampleRate_ > 1.0 ? sampleRate_ : 44100.0);
-    rebuildPaths();
-    repaint();
+void EqPlotComponent::parameterChanged(const juce::String&, float) {
+    parametersChanged_ = true;
+}
+
+void EqPlotComponent::updateFrame() {
+    if (wheelGestureActive_ && juce::Time::getMillisecondCounterHiRes() - lastWheelMs_ > WheelGestureTimeoutMs)
+        endGesture();
+    else
+        gestureWriter_.flush();
+
+    if (parametersChanged_.exchange(false))
+        refreshResponse();
+
+    const auto plotBounds = getPlotBounds();
+    if (const auto* result = responseWorker_.takeLatestResult()) {
+        if (applyResponseCurves(*result, plotBounds))
+            curveLayerDirty_ = true;
+    }
+
+    const bool spectrumChanged = spectrumAnalyzer_.update(sampleRate_, plotBounds);
+
+    // The analyzer sits under the curve layer inside the plot, so a new spectrum alone only dirties that area.
+    if (curveLayerDirty_)
+        repaint();
+    else if (spectrumChanged)
+        repaint(plotBounds.getSmallestIntegerContainer());
+}
+
+double EqPlotComponent::takePaintCostMs() noexcept {
+    return std::exchange(paintCostMs_, 0.0);
 }
 
 juce::Rectangle<float> EqPlotComponent::getPlotBounds() const {
@@ -211,67 +270,151 @@ juce::Rectangle<float> EqPlotComponent::getPlotBounds() const {
 
 void EqPlotComponent::rebuildFrequencyAxis() {
     const auto plotBounds = getPlotBounds();
-    const auto pointCount = juce::jmax(static_cast<int>(plotBounds.getWidth()), 2);
-    frequenciesHz_.resize(static_cast<std::size_t>(pointCount));
+    responseAxis_.numPoints = juce::jmax(static_cast<int>(plotBounds.getWidth()), 2);
+    responseAxis_.minFrequencyHz = MinFrequencyHz;
+    responseAxis_.maxFrequencyHz = juce::jmin(sampleRate_ * 0.495, 20000.0);
+}
 
-    const float maxFrequency = static_cast<float>(juce::jmin(sampleRate_ * 0.495, 20000.0));
-    const double ratio = maxFrequency / MinFrequencyHz;
-    const double denominator = static_cast<double>(pointCount - 1);
+void EqPlotComponent::refreshResponse() {
+    const auto plotBounds = getPlotBounds();
+
+    // Snapshots are a handful of atomic loads; the curves themselves are evaluated on the worker and picked up
+    // here once they are ready, so a slow frame never blocks the message thread.
+    ResponseCurveWorker::Request request;
+    request.axis = responseAxis_;
+    request.primary = dsp::ResponseCurve::capture(params_, sampleRate_, getDisplayBank());
+    request.includeSecondary = shouldDrawSecondaryResponse();
+    if (request.includeSecondary)
+        request.secondary = dsp::ResponseCurve::capture(params_, sampleRate_, getSecondaryDisplayBank());
+    responseWorker_.submit(request);
+
+    const auto& state = request.primary;
+    const int numShownBands = getNumShownBands();
+    for (int i = 0; i < numShownBands; ++i) {
+        const auto& band = state.bands[static_cast<std::size_t>(i)];
+        const float rawX = frequencyToX(band.frequencyHz, plotBounds);
+        const float rawY = usesGainAxis(band.type) ? dbToY(band.gainDb, plotBounds) : dbToY(0.0f, plotBounds);
 
-    for (int i = 0; i < pointCount; ++i) {
-        const double normalized = static_cast<double>(i) / denominator;
-        frequenciesHz_[static_cast<std::size_t>(i)] = MinFrequencyHz * std::pow(ratio, normalized);
+        constexpr float maxNodeRadius = 11.0f;
+        const float x = juce::jlimit(plotBounds.getX() + maxNodeRadius, plotBounds.getRight() - maxNodeRadius, rawX);
+        const float y = juce::jlimit(plotBounds.getY() + maxNodeRadius, plotBounds.getBottom() - maxNodeRadius, rawY);
+        nodePositions_[static_cast<std::size_t>(i)] = {x, y};
     }
-}
 
-void EqPlotComponent::rebuildPaths() {
-    if (frequenciesHz_.empty())
-        rebuildFrequencyAxis();
+    // Node positions and the legend follow the parameters immediately; the curves follow once the worker is done.
+    curveLayerDirty_ = true;
+}
 
-    const auto plotBounds = getPlotBounds();
-    const auto primaryBank = getDisplayBank();
-    const auto state = dsp::ResponseCurve::capture(params_, sampleRate_, primaryBank);
-    magnitudeDb_ = dsp::ResponseCurve::computeMagnitudeDb(state, frequenciesHz_);
-
-    primaryResponsePath_.clear();
-    for (std::size_t i = 0; i < magnitudeDb_.size(); ++i) {
-        const auto x = plotBounds.getX() + static_cast<float>(i);
-        const auto y = dbToY(magnitudeDb_[i], plotBounds);
-
-        if (i == 0)
-            primaryResponsePath_.startNewSubPath(x, y);
-        else
-            primaryResponsePath_.lineTo(x, y);
-    }
+bool EqPlotComponent::applyResponseCurves(const ResponseCurveWorker::Result& result,
+                                          juce::Rectangle<float> plotBounds) {
+    // A result computed for a previous size would be drawn stretched; wait for the one matching the current axis.
+    if (result.axis != responseAxis_)
+        return false;
 
-    secondaryResponsePath_.clear();
-    secondaryMagnitudeDb_.clear();
-    if (shouldDrawSecondaryResponse()) {
-        const auto secondaryState = dsp::ResponseCurve::capture(params_, sampleRate_, getSecondaryDisplayBank());
-        secondaryMagnitudeDb_ = dsp::ResponseCurve::computeMagnitudeDb(secondaryState, frequenciesHz_);
-        for (std::size_t i = 0; i < secondaryMagnitudeDb_.size(); ++i) {
-            const auto x = plotBounds.getX() + static_cast<float>(i);
-            const auto y = dbToY(secondaryMagnitudeDb_[i], plotBounds);
+    // One vertex per pixel is far more than a stroke needs; simplifying first makes both the stroking and the
+    // software rasterisation of the outline proportional to the curve's detail rather than the plot's width.
+    auto buildPath = [this, plotBounds](const std::vector<float>& magnitudeDb, juce::Path& path, juce::Path& stroke,
+                                        float thickness) {
+        responsePoints_.resize(magnitudeDb.size());
+        for (std::size_t i = 0; i < magnitudeDb.size(); ++i)
+            responsePoints_[i] = {plotBounds.getX() + static_cast<float>(i), dbToY(magnitudeDb[i], plotBounds)};
 
+        const auto& points = pathSimplifier_.simplify(responsePoints_, ResponsePathTolerance);
+        path.clear();
+        path.preallocateSpace(static_cast<int>(points.size()) * 3);
+        for (std::size_t i = 0; i < points.size(); ++i) {
             if (i == 0)
-                secondaryResponsePath_.startNewSubPath(x, y);
+                path.startNewSubPath(points[i]);
             else
-                secondaryResponsePath_.lineTo(x, y);
+                path.lineTo(points[i]);
         }
+
+        stroke.clear();
+        juce::PathStrokeType(thickness, juce::PathStrokeType::curved).createStrokedPath(stroke, path);
+    };
+
+    buildPath(result.primaryDb, primaryResponsePath_, primaryResponseStroke_, 2.2f);
+
+    if (result.hasSecondary) {
+        buildPath(result.secondaryDb, secondaryResponsePath_, secondaryResponseStroke_, 1.75f);
+    } else {
+        secondaryResponsePath_.clear();
+        secondaryResponseStroke_.clear();
     }
 
-    for (int i = 0; i < util::Params::NumBands; ++i) {
-        const auto& band = state.bands[static_cast<std::size_t>(i)];
-        const float rawX = frequencyToX(band.frequencyHz, plotBounds);
-        const float rawY = usesGainAxis(band.type) ? dbToY(band.gainDb, plotBounds) : dbToY(0.0f, plotBounds);
+    return true;
+}
 
-        constexpr float maxNodeRadius = 11.0f;
-        const float x = juce::jlimit(plotBounds.getX() + maxNodeRadius, plotBounds.getRight() - maxNodeRadius, rawX);
-        const float y = juce::jlimit(plotBounds.getY() + maxNodeRadius, plotBounds.getBottom() - maxNodeRadius, rawY);
-        nodePositions_[static_cast<std::size_t>(i)] = {x, y};
+void EqPlotComponent::invalidateCurveLayer() {
+    curveLayerDirty_ = true;
+    repaint();
+}
+
+void EqPlotComponent::prepareLayerImage(juce::Image& image) const {
+    const int width = juce::jmax(1, juce::roundToInt(static_cast<float>(getWidth()) * layerScale_));
+    const int height = juce::jmax(1, juce::roundToInt(static_cast<float>(getHeight()) * layerScale_));
+    if (image.isValid() && image.getWidth() == width && image.getHeight() == height) {
+        image.clear(image.getBounds());
+        return;
     }
 
-    spectrumAnalyzer_.update(sampleRate_, plotBounds);
+    image = juce::Image(juce::Image::ARGB, width, height, true);
+}
+
+void EqPlotComponent::renderGridLayer() {
+    // Rendered at the physical pixel scale so that the cached layers stay as sharp as drawing them directly.
+    prepareLayerImage(gridImage_);
+    juce::Graphics g(gridImage_);
+    g.addTransform(juce::AffineTransform::scale(layerScale_));
+
+    const auto bounds = getPlotBounds();
+    g.setColour(juce::Colour::fromRGB(30, 33, 37));
+    g.fillRoundedRectangle(bounds, 6.0f);
+    drawGrid(g, bounds);
+
+    gridLayerDirty_ = false;
+}
+
+void EqPlotComponent::renderCurveLayer() {
+    prepareLayerImage(curveImage_);
+    juce::Graphics g(curveImage_);
+    g.addTransform(juce::AffineTransform::scale(layerScale_));
+
+    const auto bounds = getPlotBounds();
+    g.saveState();
+    g.reduceClipRegion(bounds.toNearestInt());
+
+    if (!secondaryResponseStroke_.isEmpty()) {
+        g.setColour(juce::Colour::fromRGB(154, 179, 255).withAlpha(0.78f));
+        g.fillPath(secondaryResponseStroke_);
+    }
+
+    g.setColour(juce::Colour::fromRGB(118, 227, 255));
+    g.fillPath(primaryResponseStroke_);
+    g.restoreState();
+    drawResponseLegend(g, bounds);
+
+    const int numShownBands = getNumShownBands();
+    for (int i = 0; i < numShownBands; ++i) {
+        const bool enabled = getBandFieldValueForDisplay(i, BandField::Enabled) > 0.5f;
+
+        const float radius = (i == selectedBandIndex_) ? 11.0f : 9.0f;
+        const auto node = nodePositions_[static_cast<std::size_t>(i)];
+        const auto nodeBounds = juce::Rectangle<float>(radius * 2.0f, radius * 2.0f).withCentre(node);
+
+        g.setColour(enabled ? juce::Colour::fromRGB(255, 185, 67).withAlpha(0.9f)
+                            : juce::Colour::fromRGB(120, 120, 120).withAlpha(0.8f));
+        g.fillEllipse(nodeBounds);
+
+        g.setColour(juce::Colour::fromRGB(28, 30, 34));
+        g.fillEllipse(nodeBounds.reduced(2.2f));
+
+        g.setColour(enabled ? juce::Colour::fromRGB(255, 185, 67) : juce::Colour::fromRGB(100, 100, 100));
+        g.setFont(12.5f);
+        g.drawFittedText(juce::String(i + 1), nodeBounds.toNearestInt(), juce::Justification::centred, 1);
+    }
+
+    curveLayerDirty_ = false;
 }
 
 float EqPlotComponent::frequencyToX(float frequency, juce::Rectangle<float> bounds) const {
@@ -300,47 +443,15 @@ float EqPlotComponent::yToDb(float y, juce::Rectangle<float> bounds) {
     return juce::jmap(normalized, 0.0f, 1.0f, MaxDb, MinDb);
 }
 
-void EqPlotComponent::setParameterValue(const juce::String& parameterID, float value) {
-    auto* parameter = dynamic_cast<juce::RangedAudioParameter*>(params_.apvts.getParameter(parameterID));
-    if (parameter == nullptr)
-        return;
-
-    parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
-}
-
 void EqPlotComponent::setBandFieldValueForEditTarget(int bandNum, BandField field, float value) {
-    auto writeField = [&](util::Bank bank) {
-        switch (field) {
-        case BandField::Enabled:
-            setParameterValue(util::Params::IDs::enabled(bandNum, bank), value);
-            break;
-        case BandField::Type:
-            setParameterValue(util::Params::IDs::type(bandNum, bank), value);
-            break;
-        case BandField::Frequency:
-            setParameterValue(util::Params::IDs::freq(bandNum, bank), value);
-            break;
-        case BandField::Gain:
-            setParameterValue(util::Params::IDs::gain(bandNum, bank), value);
-            break;
-        case BandField::Q:
-            setParameterValue(util::Params::IDs::q(bandNum, bank), value);
-            break;
-        case BandField::Slope:
-            setParameterValue(util::Params::IDs::slope(bandNum, bank), value);
-            break;
-        }
-    };
+    // In Link mode bank A is written and the processor's LinkMirror carries the change over to bank B.
+    const auto bank = params_.getEditTarget() == util::EditTarget::B ? util::Bank::B : util::Bank::A;
+    gestureWriter_.set(*params_.handle(bandNum - 1, bank, field), value);
+}
 
-    const auto editTarget = params_.getEditTarget();
-    if (editTarget == util::EditTarget::Link) {
-        writeField(util::Bank::A);
-        writeField(util::Bank::B);
-    } else if (editTarget == util::EditTarget::B) {
-        writeField(util::Bank::B);
-    } else {
-        writeField(util::Bank::A);
-    }
+void EqPlotComponent::endGesture() {
+    gestureWriter_.end();
+    wheelGestureActive_ = false;
 }
 
 float EqPlotComponent::getBandFieldValueForDisplay(int bandIndex, BandField field) const {
@@ -358,6 +469,10 @@ float EqPlotComponent::getBandFieldValueForDisplay(int bandIndex, BandField fiel
         return band.q->load(std::memory_order_relaxed);
     case BandField::Slope:
         return band.slope->load(std::memory_order_relaxed);
+    case BandField::CutSlope:
+        return band.cutSlope->load(std::memory_order_relaxed);
+    case BandField::CutShape:
+        return band.cutShape->load(std::memory_order_relaxed);
     }
 
     return 0.0f;
@@ -405,17 +520,54 @@ void EqPlotComponent::drawResponseLegend(juce::Graphics& g, juce::Rectangle<floa
 }
 
 void EqPlotComponent::resetBandToDefaults(int bandIndex) {
-    if (bandIndex < 0 || bandIndex >= util::Params::NumBands)
+    if (bandIndex < 0 || bandIndex >= util::Params::MaxBands)
         return;
 
+    // One gesture for the whole reset, written straight away.
     const int bandNum = bandIndex + 1;
+    endGesture();
+    gestureWriter_.begin();
     setBandFieldValueForEditTarget(bandNum, BandField::Enabled, 1.0f);
     setBandFieldValueForEditTarget(bandNum, BandField::Type,
                                    static_cast<float>(util::Params::defaultTypeIndexForBand(bandNum)));
     setBandFieldValueForEditTarget(bandNum, BandField::Frequency, util::Params::defaultFrequencyHzForBand(bandNum));
     setBandFieldValueForEditTarget(bandNum, BandField::Gain, util::Params::defaultGainDb());
     setBandFieldValueForEditTarget(bandNum, BandField::Q, util::Params::defaultQ());
-    setBandFieldValueForEditTarget(bandNum, BandField::Slope, static_cast<float>(util::Params::defaultSlopeIndex()));
+    setBandFieldValueForEditTarget(bandNum, BandField::CutSlope, static_cast<float>(util::Params::defaultSlopeIndex()));
+    setBandFieldValueForEditTarget(bandNum, BandField::CutShape,
+                                   static_cast<float>(util::Params::defaultCutShapeIndex()));
+    endGesture();
+}
+
+int EqPlotComponent::addBand(float frequencyHz, float gainDb) {
+    const int bandIndex = params_.getUsedBandCount();
+    if (bandIndex >= util::Params::MaxBands)
+        return -1;
+
+    const int bandNum = bandIndex + 1;
+    endGesture();
+    gestureWriter_.begin();
+    setBandFieldValueForEditTarget(bandNum, BandField::Enabled, 1.0f);
+    setBandFieldValueForEditTarget(bandNum, BandField::Type, static_cast<float>(util::FilterType::Peak));
+    setBandFieldValueForEditTarget(bandNum, BandField::Frequency, frequencyHz);
+    setBandFieldValueForEditTarget(bandNum, BandField::Gain, gainDb);
+    setBandFieldValueForEditTarget(bandNum, BandField::Q, util::Params::defaultQ());
+    setBandFieldValueForEditTarget(bandNum, BandField::CutSlope, static_cast<float>(util::Params::defaultSlopeIndex()));
+    setBandFieldValueForEditTarget(bandNum, BandField::CutShape,
+                                   static_cast<float>(util::Params::defaultCutShapeIndex()));
+    endGesture();
+
+    selectedBandIndex_ = bandIndex;
+    if (bandSelectionCallback_ != nullptr)
+        bandSelectionCallback_(bandIndex);
+
+    parametersChanged_ = true;
+    invalidateCurveLayer();
+    return bandIndex;
+}
+
+int EqPlotComponent::getNumShownBands() const noexcept {
+    return juce::jmax(params_.getUsedBandCount(), selectedBandIndex_ + 1);
 }
 
 void EqPlotComponent::updateSoloStateForModifier(int bandIndex, const juce::ModifierKeys& modifiers) {
@@ -441,7 +593,8 @@ int EqPlotComponent::findNearestNode(juce::Point<float> position, float threshol
     float bestDistance = threshold;
     int bestIndex = -1;
 
-    for (int i = 0; i < util::Params::NumBands; ++i) {
+    const int numShownBands = getNumShownBands();
+    for (int i = 0; i < numShownBands; ++i) {
         const auto distance = position.getDistanceFrom(nodePositions_[static_cast<std::size_t>(i)]);
         if (distance < bestDistance) {
             bestDistance = distance;
@@ -457,8 +610,7 @@ bool EqPlotComponent::usesGainAxis(util::FilterType type) noexcept {
 }
 
 util::FilterType EqPlotComponent::getBandType(int bandIndex) const noexcept {
-    const auto& band = params_.getBand(bandIndex, getDisplayBank());
-    return static_cast<util::FilterType>(static_cast<int>(band.type->load(std::memory_order_relaxed)));
+    return params_.getBand(bandIndex, getDisplayBank()).getFilterType();
 }
 
 void EqPlotComponent::drawGrid(juce::Graphics& g, juce::Rectangle<float> bounds) {
@@ -530,4 +682,95 @@ void EqPlotComponent::drawGrid(juce::Graphics& g, juce::Rectangle<float> bounds)
     }
 }
 
+void EqPlotComponent::showAnalyzerMenu() {
+    using Analyzer = SpectrumAnalyzer;
+    const auto current = spectrumAnalyzer_.getSettings();
+
+    auto apply = [this](auto&& change) {
+        auto settings = spectrumAnalyzer_.getSettings();
+        change(settings);
+        spectrumAnalyzer_.setSettings(settings);
+    };
+
+    juce::PopupMenu fftSizeMenu;
+    for (int order = Analyzer::Settings::MinFFTOrder; order <= Analyzer::Settings::MaxFFTOrder; ++order) {
+        fftSizeMenu.addItem(juce::String(1 << order), true, current.fftOrder == order,
+                            [apply, order] { apply([order](Analyzer::Settings& s) { s.fftOrder = order; }); });
+    }
+
+    juce::PopupMenu overlapMenu;
+    overlapMenu.addItem("50%", true, current.overlap == Analyzer::Overlap::Percent50,
+                        [apply] { apply([](Analyzer::Settings& s) { s.overlap = Analyzer::Overlap::Percent50; }); });
+    overlapMenu.addItem("75%", true, current.overlap == Analyzer::Overlap::Percent75,
+                        [apply] { apply([](Analyzer::Settings& s) { s.overlap = Analyzer::Overlap::Percent75; }); });
+
+    juce::PopupMenu averagingMenu;
+    const std::array<std::pair<const char*, Analyzer::Averaging>, 3> averagingModes{
+        {{"Off", Analyzer::Averaging::Off},
+         {"Exponential", Analyzer::Averaging::Exponential},
+         {"Welch", Analyzer::Averaging::Welch}}};
+    for (const auto& [name, mode] : averagingModes) {
+        averagingMenu.addItem(name, true, current.averaging == mode,
+                              [apply, mode = mode] { apply([mode](Analyzer::Settings& s) { s.averaging = mode; }); });
+    }
+    averagingMenu.addSeparator();
+    for (const int frames : {2, 4, 8, 16}) {
+        const bool averagingEnabled = current.averaging != Analyzer::Averaging::Off;
+        averagingMenu.addItem(juce::String(frames) + " frames", averagingEnabled, current.averagingFrames == frames,
+                              [apply, frames] {
+                                  apply([frames](Analyzer::Settings& s) { s.averagingFrames = frames; });
+                              });
+    }
+
+    juce::PopupMenu smoothingMenu;
+    for (const int fraction : {0, 3, 6, 12, 24}) {
+        smoothingMenu.addItem(fraction == 0 ? juce::String("Off") : "1/" + juce::String(fraction) + " octave", true,
+                              current.smoothingOctaveFraction == fraction, [apply, fraction] {
+                                  apply([fraction](Analyzer::Settings& s) { s.smoothingOctaveFraction = fraction; });
+                              });
+    }
+    smoothingMenu.addSeparator();
+    const std::array<std::pair<const char*, Analyzer::ColumnReduction>, 2> columnReductions{
+        {{"Peak per Pixel", Analyzer::ColumnReduction::Max}, {"Average per Pixel", Analyzer::ColumnReduction::Mean}}};
+    for (const auto& [name, reduction] : columnReductions) {
+        smoothingMenu.addItem(name, true, current.columnReduction == reduction, [apply, reduction = reduction] {
+            apply([reduction](Analyzer::Settings& s) { s.columnReduction = reduction; });
+        });
+    }
+
+    juce::PopupMenu sourceMenu;
+    const std::array<std::pair<const char*, Analyzer::Source>, 7> sources{{{"Left", Analyzer::Source::Left},
+                                                                           {"Right", Analyzer::Source::Right},
+                                                                           {"L + R", Analyzer::Source::Sum},
+                                                                           {"Mid", Analyzer::Source::Mid},
+                                                                           {"Side", Analyzer::Source::Side},
+                                                                           {"Bank A", Analyzer::Source::BankA},
+                                                                           {"Bank B", Analyzer::Source::BankB}}};
+    for (const auto& [name, source] : sources) {
+        sourceMenu.addItem(name, true, current.source == source,
+                           [apply, source = source] { apply([source](Analyzer::Settings& s) { s.source = source; }); });
+    }
+
+    juce::PopupMenu menu;
+    menu.addSectionHeader("Analyzer");
+    menu.addSubMenu("Source", sourceMenu);
+    menu.addItem("Spectrogram", true, current.view == Analyzer::View::Spectrogram, [apply] {
+        apply([](Analyzer::Settings& s) {
+            s.view = s.view == Analyzer::View::Spectrogram ? Analyzer::View::Spectrum : Analyzer::View::Spectrogram;
+        });
+    });
+    menu.addItem("Multi-resolution", true, current.multiResolution,
+                 [apply] { apply([](Analyzer::Settings& s) { s.multiResolution = !s.multiResolution; }); });
+    menu.addSubMenu("FFT Size", fftSizeMenu, !current.multiResolution);
+    menu.addSubMenu("Overlap", overlapMenu, !current.multiResolution);
+    menu.addSubMenu("Averaging", averagingMenu);
+    // The waterfall draws raw levels, so curve smoothing and peak hold do not apply to it.
+    const bool spectrumView = current.view == Analyzer::View::Spectrum;
+    menu.addSubMenu("Smoothing", smoothingMenu, spectrumView);
+    menu.addItem("Peak Hold", spectrumView, current.peakHold,
+                 [apply] { apply([](Analyzer::Settings& s) { s.peakHold = !s.peakHold; }); });
+
+    menu.showMenuAsync(juce::PopupMenu::Options().withTargetComponent(this).withMousePosition());
+}
+
 } // namespace ui
@@ -2,21 +2,38 @@
 
 #include "../dsp/ResponseCurve.h"
 #include "../util/Params.h"
+#include "ParameterGestureWriter.h"
+#include "PolylineSimplifier.h"
+#include "ResponseCurveWorker.h"
 #include "SpectrumAnalyzer.h"
+#include <atomic>
 #include <functional>
 #include <juce_gui_basics/juce_gui_basics.h>
 
 namespace ui {
 
-class EqPlotComponent final : public juce::Component, private juce::Timer {
+// Drawn as three layers: a cached grid image (re-rendered on resize, sample-rate or display-scale changes), the live
+// analyzer, and a cached image of the response curves and nodes (re-rendered when a parameter or the selection
+// changes). Frames are driven by the editor; with no parameter changes and a silent analyzer they do not repaint.
+class EqPlotComponent final : public juce::Component, private juce::AudioProcessorValueTreeState::Listener {
   public:
     EqPlotComponent(util::Params& params, SpectrumAnalyzer& spectrumAnalyzer);
+    ~EqPlotComponent() override;
 
     void setSampleRate(double sampleRate);
     void setSelectedBand(int index);
     [[nodiscard]] int getSelectedBand() const noexcept { return selectedBandIndex_; }
     void setBandSelectionCallback(std::function<void(int)> callback);
     void setBandSoloCallback(std::function<void(int, bool)> callback);
+    // Enables the first band past those in use as a peak at the given point, as one gesture, and selects it. Also
+    // what a double-click on an empty part of the plot does. Returns the band index, or -1 if every band is in use.
+    int addBand(float frequencyHz, float gainDb);
+
+    // Called by the editor once per UI frame: picks up parameter changes, new curves and new spectra, and repaints
+    // whatever they touched.
+    void updateFrame();
+    // Time spent in paint() since the last call, in milliseconds.
+    [[nodiscard]] double takePaintCostMs() noexcept;
 
     void paint(juce::Graphics& g) override;
     void resized() override;
@@ -28,19 +45,32 @@ class EqPlotComponent final : public juce::Component, private juce::Timer {
     void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
 
   private:
-    enum class BandField { Enabled, Type, Frequency, Gain, Q, Slope };
+    using BandField = util::BandField;
 
     util::Params& params_;
     SpectrumAnalyzer& spectrumAnalyzer_;
     std::function<void(int)> bandSelectionCallback_;
     std::function<void(int, bool)> bandSoloCallback_;
 
-    std::vector<double> frequenciesHz_;
-    std::vector<float> magnitudeDb_;
-    std::vector<float> secondaryMagnitudeDb_;
+    ResponseCurveWorker responseWorker_;
+    ResponseCurveWorker::Axis responseAxis_;
     juce::Path primaryResponsePath_;
     juce::Path secondaryResponsePath_;
-    std::array<juce::Point<float>, util::Params::NumBands> nodePositions_{};
+    // Outlines of the simplified curves, stroked once per new curve rather than on every curve-layer render.
+    juce::Path primaryResponseStroke_;
+    juce::Path secondaryResponseStroke_;
+    PolylineSimplifier pathSimplifier_;
+    std::vector<juce::Point<float>> responsePoints_;
+    std::array<juce::Point<float>, util::Params::MaxBands> nodePositions_{};
+
+    juce::Image gridImage_;
+    juce::Image curveImage_;
+    float layerScale_ = 0.0f;
+    bool gridLayerDirty_ = true;
+    bool curveLayerDirty_ = true;
+    // Parameter listeners may fire on any thread; the message thread consumes this on its next frame.
+    std::atomic<bool> parametersChanged_{true};
+    double paintCostMs_ = 0.0;
 
     double sampleRate_ = 44100.0;
     int selectedBandIndex_ = -1;
@@ -51,31 +81,47 @@ class EqPlotComponent final : public juce::Component, private juce::Timer {
     float dragStartFrequencyHz_ = 1000.0f;
     float dragStartGainDb_ = 0.0f;
     float dragStartQ_ = 1.0f;
+    // Node edits go to the host as gestures, flushed once per frame. A press on a node holds one open until release;
+    // wheel edits hold one until the wheel has been idle for WheelGestureTimeoutMs.
+    static constexpr double WheelGestureTimeoutMs = 250.0;
+    ParameterGestureWriter gestureWriter_;
+    bool wheelGestureActive_ = false;
+    double lastWheelMs_ = 0.0;
 
-    void timerCallback() override;
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
 
     [[nodiscard]] juce::Rectangle<float> getPlotBounds() const;
     void rebuildFrequencyAxis();
-    void rebuildPaths();
+    void refreshResponse();
+    [[nodiscard]] bool applyResponseCurves(const ResponseCurveWorker::Result& result,
+                                           juce::Rectangle<float> plotBounds);
+    void invalidateCurveLayer();
+    // Allocates only when the component size or pixel scale has changed; otherwise clears the existing image.
+    void prepareLayerImage(juce::Image& image) const;
+    void renderGridLayer();
+    void renderCurveLayer();
 
     [[nodiscard]] float frequencyToX(float frequency, juce::Rectangle<float> bounds) const;
     [[nodiscard]] float xToFrequency(float x, juce::Rectangle<float> bounds) const;
     [[nodiscard]] static float dbToY(float db, juce::Rectangle<float> bounds);
     [[nodiscard]] static float yToDb(float y, juce::Rectangle<float> bounds);
 
-    void setParameterValue(const juce::String& parameterID, float value);
     void setBandFieldValueForEditTarget(int bandNum, BandField field, float value);
+    void endGesture();
     [[nodiscard]] float getBandFieldValueForDisplay(int bandIndex, BandField field) const;
     [[nodiscard]] util::Bank getDisplayBank() const noexcept;
     [[nodiscard]] bool shouldDrawSecondaryResponse() const noexcept;
     [[nodiscard]] util::Bank getSecondaryDisplayBank() const noexcept;
     void drawResponseLegend(juce::Graphics& g, juce::Rectangle<float> bounds) const;
     void resetBandToDefaults(int bandIndex);
+    // The bands in use plus the selected one; only these get nodes.
+    [[nodiscard]] int getNumShownBands() const noexcept;
     void updateSoloStateForModifier(int bandIndex, const juce::ModifierKeys& modifiers);
     [[nodiscard]] int findNearestNode(juce::Point<float> position, float threshold) const;
     [[nodiscard]] static bool usesGainAxis(util::FilterType type) noexcept;
     [[nodiscard]] util::FilterType getBandType(int bandIndex) const noexcept;
     void drawGrid(juce::Graphics& g, juce::Rectangle<float> bounds);
+    void showAnalyzerMenu();
 };
 
 } // namespace ui
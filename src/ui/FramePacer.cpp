@@ -0,0 +1,52 @@
+#include "FramePacer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ui {
+namespace {
+
+// Refresh gaps longer than this are a hidden window or a stalled message thread, not the display's rate.
+constexpr double MaxPlausibleIntervalMs = 100.0;
+constexpr double IntervalSmoothing = 0.1;
+constexpr double CostSmoothing = 0.2;
+
+} // namespace
+
+bool FramePacer::onVBlank(double nowMs) noexcept {
+    if (lastVBlankMs_ >= 0.0) {
+        const double interval = nowMs - lastVBlankMs_;
+        if (interval > 0.0 && interval < MaxPlausibleIntervalMs) {
+            vBlankIntervalMs_ += IntervalSmoothing * (interval - vBlankIntervalMs_);
+            const double framePeriodMs = 1000.0 / MaxFrameRateHz;
+            rateDivider_ = std::max(1, static_cast<int>(std::lround(framePeriodMs / vBlankIntervalMs_)));
+        }
+    }
+    lastVBlankMs_ = nowMs;
+
+    if (--vBlanksUntilFrame_ > 0)
+        return false;
+
+    vBlanksUntilFrame_ = getDivider();
+    return true;
+}
+
+void FramePacer::reportFrameCost(double costMs) noexcept {
+    averageCostMs_ += CostSmoothing * (std::max(costMs, 0.0) - averageCostMs_);
+
+    const double budgetPerVBlank = BudgetFraction * vBlankIntervalMs_ * rateDivider_;
+    if (averageCostMs_ > budgetPerVBlank * loadDivider_) {
+        loadDivider_ = std::min(loadDivider_ + 1, MaxLoadDivider);
+    } else if (loadDivider_ > 1 && averageCostMs_ < 0.5 * budgetPerVBlank * (loadDivider_ - 1)) {
+        // Only speed up when frames would comfortably fit the faster rate, so the divider does not oscillate.
+        --loadDivider_;
+    }
+}
+
+void FramePacer::reset() noexcept {
+    lastVBlankMs_ = -1.0;
+    averageCostMs_ = 0.0;
+    loadDivider_ = 1;
+    vBlanksUntilFrame_ = 0;
+}
+
+} // namespace ui
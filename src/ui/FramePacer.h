@@ -0,0 +1,35 @@
+#pragma once
+
+namespace ui {
+
+// Decides which display refreshes produce a UI frame. Frames are capped near MaxFrameRateHz whatever the refresh
+// rate, and while the measured cost of a frame (update plus paint) stays above its share of the frame period the
+// rate drops to 1/2, 1/3... of that, so a slow software renderer costs frame rate rather than message-thread time.
+// It recovers once frames are cheap again. Message thread only; no clock of its own, the caller passes timestamps.
+class FramePacer final {
+  public:
+    static constexpr double MaxFrameRateHz = 60.0;
+    static constexpr int MaxLoadDivider = 4;
+    // Fraction of the frame period a frame may spend on the message thread before the rate is reduced.
+    static constexpr double BudgetFraction = 0.5;
+
+    // Call on every display refresh with a millisecond timestamp; returns true when this one should produce a frame.
+    [[nodiscard]] bool onVBlank(double nowMs) noexcept;
+    // Cost in milliseconds of the frame produced after the last onVBlank() that returned true.
+    void reportFrameCost(double costMs) noexcept;
+    // Forgets timing history, e.g. after the window was hidden.
+    void reset() noexcept;
+
+    [[nodiscard]] int getDivider() const noexcept { return rateDivider_ * loadDivider_; }
+    [[nodiscard]] double getVBlankIntervalMs() const noexcept { return vBlankIntervalMs_; }
+
+  private:
+    double lastVBlankMs_ = -1.0;
+    double vBlankIntervalMs_ = 1000.0 / MaxFrameRateHz;
+    double averageCostMs_ = 0.0;
+    int rateDivider_ = 1;
+    int loadDivider_ = 1;
+    int vBlanksUntilFrame_ = 0;
+};
+
+} // namespace ui
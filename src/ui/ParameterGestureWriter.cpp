@@ -0,0 +1,53 @@
+#include "ParameterGestureWriter.h"
+#include <algorithm>
+
+namespace ui {
+
+ParameterGestureWriter::~ParameterGestureWriter() {
+    end();
+}
+
+void ParameterGestureWriter::set(juce::RangedAudioParameter& parameter, float value) {
+    const float normalisedValue = parameter.convertTo0to1(value);
+    if (!active_) {
+        parameter.beginChangeGesture();
+        parameter.setValueNotifyingHost(normalisedValue);
+        parameter.endChangeGesture();
+        return;
+    }
+
+    auto entry = std::find_if(entries_.begin(), entries_.end(),
+                              [&parameter](const Entry& candidate) { return candidate.parameter == &parameter; });
+    if (entry == entries_.end()) {
+        parameter.beginChangeGesture();
+        entry = entries_.insert(entries_.end(), Entry{&parameter});
+    }
+
+    entry->normalisedValue = normalisedValue;
+    entry->pending = true;
+}
+
+void ParameterGestureWriter::flush() {
+    for (auto& entry : entries_)
+        write(entry);
+}
+
+void ParameterGestureWriter::end() {
+    flush();
+    for (const auto& entry : entries_)
+        entry.parameter->endChangeGesture();
+
+    entries_.clear();
+    active_ = false;
+}
+
+void ParameterGestureWriter::write(Entry& entry) {
+    if (!entry.pending)
+        return;
+
+    entry.pending = false;
+    if (entry.parameter->getValue() != entry.normalisedValue)
+        entry.parameter->setValueNotifyingHost(entry.normalisedValue);
+}
+
+} // namespace ui
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+namespace ui {
+
+// Turns a stream of UI edits into host gestures with at most one value notification per parameter per frame.
+// Between begin() and end(), set() only records the latest value (opening the parameter's change gesture the first
+// time it is touched); flush() sends whatever changed since the last one, and end() flushes and closes every gesture
+// it opened. Outside begin()/end(), set() writes immediately inside a gesture of its own. Message thread only.
+class ParameterGestureWriter final {
+  public:
+    ParameterGestureWriter() = default;
+    ~ParameterGestureWriter();
+
+    void begin() noexcept { active_ = true; }
+    // `value` is in the parameter's own range.
+    void set(juce::RangedAudioParameter& parameter, float value);
+    void flush();
+    void end();
+
+    [[nodiscard]] bool isActive() const noexcept { return active_; }
+
+  private:
+    struct Entry {
+        juce::RangedAudioParameter* parameter = nullptr;
+        float normalisedValue = 0.0f;
+        bool pending = false;
+    };
+
+    // A drag touches two or three parameters, so a linear search beats anything keyed.
+    std::vector<Entry> entries_;
+    bool active_ = false;
+
+    static void write(Entry& entry);
+
+    JUCE_DECLARE_NON_COPYABLE(ParameterGestureWriter)
+};
+
+} // namespace ui
@@ -0,0 +1,74 @@
+#include "PolylineSimplifier.h"
+
+namespace ui {
+namespace {
+
+float squaredDistanceToSegment(juce::Point<float> point, juce::Point<float> start, juce::Point<float> end) noexcept {
+    const float dx = end.x - start.x;
+    const float dy = end.y - start.y;
+    const float lengthSquared = dx * dx + dy * dy;
+
+    float t = 0.0f;
+    if (lengthSquared > 0.0f)
+        t = juce::jlimit(0.0f, 1.0f, ((point.x - start.x) * dx + (point.y - start.y) * dy) / lengthSquared);
+
+    const float offsetX = point.x - (start.x + t * dx);
+    const float offsetY = point.y - (start.y + t * dy);
+    return offsetX * offsetX + offsetY * offsetY;
+}
+
+} // namespace
+
+const std::vector<juce::Point<float>>& PolylineSimplifier::simplify(const std::vector<juce::Point<float>>& points,
+                                                                    float tolerance) {
+    result_.clear();
+    const int numPoints = static_cast<int>(points.size());
+    if (numPoints <= 2) {
+        result_.assign(points.begin(), points.end());
+        return result_;
+    }
+
+    keep_.assign(points.size(), 0);
+    keep_.front() = 1;
+    keep_.back() = 1;
+
+    const float toleranceSquared = tolerance * tolerance;
+    pending_.clear();
+    pending_.emplace_back(0, numPoints - 1);
+
+    while (!pending_.empty()) {
+        const auto [first, last] = pending_.back();
+        pending_.pop_back();
+
+        const auto start = points[static_cast<std::size_t>(first)];
+        const auto end = points[static_cast<std::size_t>(last)];
+        float furthestDistance = toleranceSquared;
+        int furthest = -1;
+
+        for (int i = first + 1; i < last; ++i) {
+            const float distance = squaredDistanceToSegment(points[static_cast<std::size_t>(i)], start, end);
+            if (distance > furthestDistance) {
+                furthestDistance = distance;
+                furthest = i;
+            }
+        }
+
+        if (furthest < 0)
+            continue;
+
+        keep_[static_cast<std::size_t>(furthest)] = 1;
+        if (furthest - first > 1)
+            pending_.emplace_back(first, furthest);
+        if (last - furthest > 1)
+            pending_.emplace_back(furthest, last);
+    }
+
+    for (std::size_t i = 0; i < points.size(); ++i) {
+        if (keep_[i] != 0)
+            result_.push_back(points[i]);
+    }
+
+    return result_;
+}
+
+} // namespace ui
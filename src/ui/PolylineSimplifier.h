@@ -0,0 +1,23 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <utility>
+#include <vector>
+
+namespace ui {
+
+// Ramer-Douglas-Peucker simplification of an open polyline. Keeps both end points and every point needed for the
+// result to stay within `tolerance` of the input, so a response curve with one vertex per pixel collapses to a few
+// dozen vertices along its flat and gently curving stretches. Iterative; the buffers are reused between calls.
+class PolylineSimplifier final {
+  public:
+    // The returned points stay valid until the next call.
+    const std::vector<juce::Point<float>>& simplify(const std::vector<juce::Point<float>>& points, float tolerance);
+
+  private:
+    std::vector<char> keep_;
+    std::vector<std::pair<int, int>> pending_;
+    std::vector<juce::Point<float>> result_;
+};
+
+} // namespace ui
@@ -0,0 +1,80 @@
+#include "PresetBrowser.h"
+#include <algorithm>
+
+namespace ui {
+
+PresetBrowser::PresetBrowser(std::shared_ptr<const util::PresetBank> bank, int currentIndex,
+                             std::function<void(int)> presetChosenCallback)
+    : bank_(std::move(bank)), presetChosenCallback_(std::move(presetChosenCallback)) {
+    searchField_.setTextToShowWhenEmpty(bank_->size() > 0 ? "Search presets or tags" : "No preset bank installed",
+                                        juce::Colour::fromRGB(140, 144, 150));
+    searchField_.onTextChange = [this] { updateResults(-1); };
+    searchField_.onReturnKey = [this] {
+        if (!results_.empty())
+            list_.selectRow(0);
+    };
+    addAndMakeVisible(searchField_);
+
+    list_.setModel(this);
+    list_.setRowHeight(24);
+    addAndMakeVisible(list_);
+
+    setSize(300, 340);
+    updateResults(currentIndex);
+}
+
+void PresetBrowser::paint(juce::Graphics& g) {
+    g.fillAll(juce::Colour::fromRGB(40, 43, 48));
+}
+
+void PresetBrowser::resized() {
+    auto bounds = getLocalBounds().reduced(6);
+    searchField_.setBounds(bounds.removeFromTop(26));
+    bounds.removeFromTop(6);
+    list_.setBounds(bounds);
+}
+
+void PresetBrowser::updateResults(int indexToSelect) {
+    results_ = bank_->search(searchField_.getText());
+    list_.updateContent();
+
+    // Selecting the current preset is only a highlight; it must not reload it.
+    const auto found = std::find(results_.begin(), results_.end(), indexToSelect);
+    if (found != results_.end()) {
+        const juce::ScopedValueSetter<bool> highlightOnly(highlightingOnly_, true);
+        list_.selectRow(static_cast<int>(found - results_.begin()));
+    }
+}
+
+int PresetBrowser::getNumRows() {
+    return static_cast<int>(results_.size());
+}
+
+void PresetBrowser::paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) {
+    if (row < 0 || row >= getNumRows())
+        return;
+
+    if (rowIsSelected)
+        g.fillAll(juce::Colour::fromRGB(118, 227, 255).withAlpha(0.22f));
+
+    const int index = results_[static_cast<std::size_t>(row)];
+    auto area = juce::Rectangle<int>(0, 0, width, height).reduced(6, 0);
+
+    g.setColour(juce::Colour::fromRGB(150, 154, 160));
+    g.setFont(juce::FontOptions{11.0f});
+    g.drawText(bank_->getTags(index).joinIntoString(", "), area.removeFromRight(width / 3),
+               juce::Justification::centredRight, true);
+
+    g.setColour(juce::Colour::fromRGB(225, 228, 231));
+    g.setFont(juce::FontOptions{14.0f});
+    g.drawText(bank_->getName(index), area, juce::Justification::centredLeft, true);
+}
+
+void PresetBrowser::selectedRowsChanged(int lastRowSelected) {
+    if (highlightingOnly_ || lastRowSelected < 0 || lastRowSelected >= getNumRows() || presetChosenCallback_ == nullptr)
+        return;
+
+    presetChosenCallback_(results_[static_cast<std::size_t>(lastRowSelected)]);
+}
+
+} // namespace ui
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "../util/PresetBank.h"
+#include <functional>
+#include <memory>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <vector>
+
+namespace ui {
+
+// Search field over a list of a bank's presets, shown in a call-out from the editor. Typing filters by name and tag
+// (see PresetBank::search); clicking a row loads that preset straight away, so a library can be auditioned by
+// clicking or arrowing down the list. The browser holds on to its bank, which stays open until the browser goes.
+class PresetBrowser final : public juce::Component, private juce::ListBoxModel {
+  public:
+    PresetBrowser(std::shared_ptr<const util::PresetBank> bank, int currentIndex,
+                  std::function<void(int)> presetChosenCallback);
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+  private:
+    std::shared_ptr<const util::PresetBank> bank_;
+    std::function<void(int)> presetChosenCallback_;
+    juce::TextEditor searchField_;
+    juce::ListBox list_;
+    // Bank indices of the rows, in name order.
+    std::vector<int> results_;
+    bool highlightingOnly_ = false;
+
+    void updateResults(int indexToSelect);
+
+    int getNumRows() override;
+    void paintListBoxItem(int row, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    void selectedRowsChanged(int lastRowSelected) override;
+};
+
+} // namespace ui
@@ -0,0 +1,81 @@
+#include "ResponseCurveWorker.h"
+#include <cmath>
+
+namespace ui {
+
+ResponseCurveWorker::ResponseCurveWorker() : juce::Thread("EQ Infinity response curves") {
+    startThread(juce::Thread::Priority::low);
+}
+
+ResponseCurveWorker::~ResponseCurveWorker() {
+    stopThread(2000);
+}
+
+void ResponseCurveWorker::submit(const Request& request) {
+    const bool unchanged = hasSubmitted_ && request.axis == lastSubmitted_.axis &&
+                           request.primary == lastSubmitted_.primary &&
+                           request.includeSecondary == lastSubmitted_.includeSecondary &&
+                           (!request.includeSecondary || request.secondary == lastSubmitted_.secondary);
+    if (unchanged)
+        return;
+
+    lastSubmitted_ = request;
+    hasSubmitted_ = true;
+
+    requests_.getWriteBuffer() = request;
+    requests_.publish();
+    notify();
+}
+
+const ResponseCurveWorker::Result* ResponseCurveWorker::takeLatestResult() noexcept {
+    return results_.acquire() ? &results_.getReadBuffer() : nullptr;
+}
+
+void ResponseCurveWorker::run() {
+    while (!threadShouldExit()) {
+        // Only the newest request is ever visible here; whatever the editor submitted while the previous curve was
+        // being computed has already been overwritten.
+        if (requests_.acquire())
+            compute(requests_.getReadBuffer());
+        else
+            wait(-1);
+    }
+}
+
+void ResponseCurveWorker::compute(const Request& request) {
+    if (request.axis != workspaceAxis_)
+        rebuildAxis(request.axis);
+
+    auto& result = results_.getWriteBuffer();
+    const auto numPoints = frequenciesHz_.size();
+    result.axis = request.axis;
+    result.primaryDb.resize(numPoints);
+    dsp::ResponseCurve::computeMagnitudeDbAdaptive(request.primary, workspace_, result.primaryDb.data());
+
+    result.hasSecondary = request.includeSecondary;
+    if (request.includeSecondary) {
+        result.secondaryDb.resize(numPoints);
+        dsp::ResponseCurve::computeMagnitudeDbAdaptive(request.secondary, workspace_, result.secondaryDb.data());
+    }
+
+    results_.publish();
+}
+
+void ResponseCurveWorker::rebuildAxis(const Axis& axis) {
+    workspaceAxis_ = axis;
+
+    const auto pointCount = juce::jmax(axis.numPoints, 2);
+    frequenciesHz_.resize(static_cast<std::size_t>(pointCount));
+
+    const double ratio = axis.maxFrequencyHz / axis.minFrequencyHz;
+    const double denominator = static_cast<double>(pointCount - 1);
+
+    for (int i = 0; i < pointCount; ++i) {
+        const double normalized = static_cast<double>(i) / denominator;
+        frequenciesHz_[static_cast<std::size_t>(i)] = axis.minFrequencyHz * std::pow(ratio, normalized);
+    }
+
+    workspace_.setFrequencies(frequenciesHz_.data(), frequenciesHz_.size());
+}
+
+} // namespace ui
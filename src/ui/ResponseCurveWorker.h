@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../dsp/ResponseCurve.h"
+#include "../util/TripleBuffer.h"
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace ui {
+
+// Computes response curves for the plot off the message thread. The editor submits parameter snapshots, the
+// worker evaluates only the latest one (anything submitted meanwhile is dropped) and publishes magnitude arrays
+// that the editor picks up on its next frame.
+class ResponseCurveWorker final : private juce::Thread {
+  public:
+    // Log-spaced frequency axis the curves are evaluated on, one point per plot pixel.
+    struct Axis {
+        int numPoints = 0;
+        double minFrequencyHz = 20.0;
+        double maxFrequencyHz = 20000.0;
+
+        [[nodiscard]] bool operator==(const Axis& other) const noexcept {
+            return numPoints == other.numPoints && minFrequencyHz == other.minFrequencyHz &&
+                   maxFrequencyHz == other.maxFrequencyHz;
+        }
+        [[nodiscard]] bool operator!=(const Axis& other) const noexcept { return !(*this == other); }
+    };
+
+    struct Request {
+        Axis axis;
+        ::dsp::ResponseCurve::State primary;
+        ::dsp::ResponseCurve::State secondary;
+        bool includeSecondary = false;
+    };
+
+    struct Result {
+        Axis axis;
+        std::vector<float> primaryDb;
+        std::vector<float> secondaryDb;
+        bool hasSecondary = false;
+    };
+
+    ResponseCurveWorker();
+    ~ResponseCurveWorker() override;
+
+    // Message thread. Requests identical to the previous one are ignored.
+    void submit(const Request& request);
+
+    // Message thread. Returns the newest finished result, or nullptr if nothing arrived since the last call.
+    [[nodiscard]] const Result* takeLatestResult() noexcept;
+
+  private:
+    util::TripleBuffer<Request> requests_;
+    util::TripleBuffer<Result> results_;
+    Request lastSubmitted_;
+    bool hasSubmitted_ = false;
+
+    Axis workspaceAxis_;
+    std::vector<double> frequenciesHz_;
+    ::dsp::ResponseCurve::Workspace workspace_;
+
+    void run() override;
+    void compute(const Request& request);
+    void rebuildAxis(const Axis& axis);
+};
+
+} // namespace ui
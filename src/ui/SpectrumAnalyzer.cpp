@@ -5,12 +5,10 @@
 namespace ui {
 namespace {
 
-float frequencyToX(float frequency, juce::Rectangle<float> bounds, float maxFrequency) {
-    constexpr float minFrequency = 20.0f;
-    const float logMin = std::log10(minFrequency);
-    const float logMax = std::log10(maxFrequency);
-    const float normalized = (std::log10(frequency) - logMin) / juce::jmax(logMax - logMin, 1.0e-6f);
-    return bounds.getX() + normalized * bounds.getWidth();
+constexpr float MinPlotFrequency = 20.0f;
+
+float normalizedToFrequency(float normalized, float maxFrequency) {
+    return MinPlotFrequency * std::pow(maxFrequency / MinPlotFrequency, normalized);
 }
 
 float dbToY(float db, juce::Rectangle<float> bounds, float minDb, float maxDb) {
@@ -18,23 +16,91 @@ float dbToY(float db, juce::Rectangle<float> bounds, float minDb, float maxDb) {
     return bounds.getY() + normalized * bounds.getHeight();
 }
 
+float powerToDb(float power, float minDb, float maxDb) noexcept {
+    return juce::jlimit(minDb, maxDb, 10.0f * std::log10(juce::jmax(power, 1.0e-20f)));
+}
+
+int getHopSize(const SpectrumAnalyzer::Settings& settings, int fftSize) noexcept {
+    return settings.overlap == SpectrumAnalyzer::Overlap::Percent75 ? fftSize / 4 : fftSize / 2;
+}
+
 } // namespace
 
 SpectrumAnalyzer::SpectrumAnalyzer(EQInfinityAudioProcessor& processor)
-    : processor_(processor), fft_(FFTOrder), window_(FFTSize, juce::dsp::WindowingFunction<float>::hann, true) {}
+    : processor_(processor), fifo_(processor.attachAnalyzer()) {
+    pre_.leftPlane = EQInfinityAudioProcessor::PreAnalyzerLeftPlane;
+    pre_.rightPlane = EQInfinityAudioProcessor::PreAnalyzerRightPlane;
+    post_.leftPlane = EQInfinityAudioProcessor::PostAnalyzerLeftPlane;
+    post_.rightPlane = EQInfinityAudioProcessor::PostAnalyzerRightPlane;
+
+    spectrogramLines_.assign(static_cast<std::size_t>(SpectrogramCapacity) * SpectrogramPoints, 0);
+
+    // Transparent at the floor so the grid shows through quiet regions, then blue through cyan to near-white.
+    const auto low = juce::Colour::fromRGB(24, 40, 120);
+    const auto mid = juce::Colour::fromRGB(60, 200, 230);
+    const auto high = juce::Colour::fromRGB(255, 240, 170);
+    for (std::size_t level = 0; level < spectrogramPalette_.size(); ++level) {
+        const float t = static_cast<float>(level) / static_cast<float>(spectrogramPalette_.size() - 1);
+        const auto colour =
+            t < 0.5f ? low.interpolatedWith(mid, t * 2.0f) : mid.interpolatedWith(high, t * 2.0f - 1.0f);
+        spectrogramPalette_[level] = colour.withAlpha(juce::jmin(1.0f, t * 1.5f)).getPixelARGB();
+    }
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer() {
+    scheduler_->cancel(*this);
+    processor_.detachAnalyzer();
+}
 
-void SpectrumAnalyzer::update(double sampleRate, juce::Rectangle<float> plotBounds) {
+bool SpectrumAnalyzer::update(double sampleRate, juce::Rectangle<float> plotBounds) {
+    const bool layoutChanged = plotBounds != bounds_ || sampleRate != pathSampleRate_;
     bounds_ = plotBounds;
 
     if (bounds_.getWidth() < 4.0f || bounds_.getHeight() < 4.0f || sampleRate <= 0.0)
-        return;
+        return false;
+
+    if (sampleRate != configSampleRate_) {
+        publishConfig(sampleRate);
+        clearSpectrogram();
+    }
+
+    const bool hasNewSpectra = spectra_.acquire();
+    hasSpectra_ = hasSpectra_ || hasNewSpectra;
+
+    const bool spectrogram = settings_.view == View::Spectrogram;
+    const bool spectrogramChanged = spectrogram && updateSpectrogram();
+    const bool pathsChanged = !spectrogram && hasSpectra_ && (hasNewSpectra || layoutChanged || pathsDirty_);
+    if (pathsChanged) {
+        const auto& spectra = spectra_.getReadBuffer();
+        if (layoutChanged || spectra.frequenciesHz != columnFrequencies_)
+            rebuildColumns(spectra.frequenciesHz, sampleRate);
+
+        buildPath(spectra.preDb, prePath_);
+        buildPath(spectra.postDb, postPath_);
+
+        if (spectra.hasPeaks) {
+            buildPath(spectra.prePeakDb, prePeakPath_);
+            buildPath(spectra.postPeakDb, postPeakPath_);
+        } else {
+            prePeakPath_.clear();
+            postPeakPath_.clear();
+        }
+
+        pathSampleRate_ = sampleRate;
+        pathsDirty_ = false;
+    }
 
-    pullFromProcessor();
-    buildPathFromHistory(preHistory_, preWritePosition_, preFftBuffer_, prePath_, sampleRate);
-    buildPathFromHistory(postHistory_, postWritePosition_, postFftBuffer_, postPath_, sampleRate);
+    // Coalesced by the scheduler: if the previous analysis has not run yet this is a no-op.
+    scheduler_->requestAnalysis(*this);
+    return pathsChanged || spectrogramChanged;
 }
 
 void SpectrumAnalyzer::draw(juce::Graphics& g) const {
+    if (settings_.view == View::Spectrogram) {
+        drawSpectrogram(g);
+        return;
+    }
+
     g.saveState();
     g.reduceClipRegion(bounds_.toNearestInt());
 
@@ -44,70 +110,637 @@ void SpectrumAnalyzer::draw(juce::Graphics& g) const {
     g.setColour(juce::Colour::fromRGB(118, 227, 255).withAlpha(0.65f));
     g.strokePath(postPath_, juce::PathStrokeType(1.5f));
 
+    if (!postPeakPath_.isEmpty()) {
+        g.setColour(juce::Colour::fromRGB(255, 164, 94).withAlpha(0.22f));
+        g.strokePath(prePeakPath_, juce::PathStrokeType(0.9f));
+
+        g.setColour(juce::Colour::fromRGB(118, 227, 255).withAlpha(0.4f));
+        g.strokePath(postPeakPath_, juce::PathStrokeType(1.0f));
+    }
+
     g.restoreState();
 }
 
-void SpectrumAnalyzer::pullFromProcessor() {
-    std::array<float, TempBlockSize> temp{};
+void SpectrumAnalyzer::setSettings(const Settings& settings) {
+    Settings sanitized = settings;
+    sanitized.fftOrder = juce::jlimit(Settings::MinFFTOrder, Settings::MaxFFTOrder, settings.fftOrder);
+    sanitized.averagingFrames = juce::jlimit(1, 64, settings.averagingFrames);
+    sanitized.smoothingOctaveFraction = juce::jlimit(0, 48, settings.smoothingOctaveFraction);
 
-    while (true) {
-        const int numRead = processor_.popPreAnalyzerSamples(temp.data(), TempBlockSize);
-        if (numRead <= 0)
-            break;
+    if (sanitized == settings_)
+        return;
+
+    // Column reduction only affects path building; everything else is analysis state.
+    auto analysisSettings = sanitized;
+    analysisSettings.columnReduction = settings_.columnReduction;
+    const bool analysisChanged = analysisSettings != settings_;
+
+    if (sanitized.view != settings_.view)
+        clearSpectrogram();
+
+    settings_ = sanitized;
+    pathsDirty_ = true;
+    if (analysisChanged && configSampleRate_ > 0.0)
+        publishConfig(configSampleRate_);
+}
+
+void SpectrumAnalyzer::publishConfig(double sampleRate) {
+    configSampleRate_ = sampleRate;
+
+    auto& config = config_.getWriteBuffer();
+    config.settings = settings_;
+    config.sampleRate = sampleRate;
+    config_.publish();
+}
+
+void SpectrumAnalyzer::runAnalysis() {
+    if (config_.acquire())
+        configure(config_.getReadBuffer());
+
+    if (!configured_)
+        return;
+
+    components_ = resolveComponents();
+    if (activeConfig_.settings.multiResolution)
+        pushMultiResolution();
+    else
+        analyseReadyFrames();
+
+    if (!pre_.hasNewFrame && !post_.hasNewFrame)
+        return;
+
+    auto& spectra = spectra_.getWriteBuffer();
+    spectra.frequenciesHz.assign(frequenciesHz_.begin(), frequenciesHz_.end());
+    writeSpectrum(pre_, spectra.preDb);
+    writeSpectrum(post_, spectra.postDb);
 
-        for (int i = 0; i < numRead; ++i) {
-            preHistory_[static_cast<std::size_t>(preWritePosition_)] = temp[static_cast<std::size_t>(i)];
-            preWritePosition_ = (preWritePosition_ + 1) % FFTSize;
+    spectra.hasPeaks = activeConfig_.settings.peakHold;
+    if (spectra.hasPeaks) {
+        // Decay by the audio time covered since the last published spectrum, so the rate does not depend on the hop.
+        const float elapsedSeconds =
+            static_cast<float>(samplesSincePeakUpdate_) / static_cast<float>(activeConfig_.sampleRate);
+        const float decayDb = PeakDecayDbPerSecond * elapsedSeconds;
+        updatePeaks(pre_, spectra.preDb, decayDb);
+        updatePeaks(post_, spectra.postDb, decayDb);
+        samplesSincePeakUpdate_ = 0;
+        spectra.prePeakDb.assign(pre_.peakDb.begin(), pre_.peakDb.end());
+        spectra.postPeakDb.assign(post_.peakDb.begin(), post_.peakDb.end());
+    }
+
+    pre_.hasNewFrame = false;
+    post_.hasNewFrame = false;
+
+    // Once the display has settled on the floor, more of the same would only cost the editor a repaint per hop.
+    const bool silent = isSilent(spectra);
+    if (silent && publishedSilence_)
+        return;
+
+    publishedSilence_ = silent;
+    spectra_.publish();
+}
+
+void SpectrumAnalyzer::configure(const Config& config) {
+    activeConfig_ = config;
+
+    if (config.settings.multiResolution) {
+        // Welch needs per-frame storage the cascaded stages do not keep; it runs as an exponential average there.
+        const int averagingFrames = config.settings.averaging == Averaging::Off ? 1 : config.settings.averagingFrames;
+        for (auto* channel : {&pre_, &post_}) {
+            for (auto& analyzer : channel->multiResolution) {
+                analyzer.prepare(config.sampleRate);
+                analyzer.setAveragingFrames(averagingFrames);
+            }
+        }
+
+        const auto& frequencies = pre_.multiResolution[0].getFrequencies();
+        frequenciesHz_.assign(frequencies.begin(), frequencies.end());
+        samplesUntilSpectrogramLine_ = MultiResolutionLineHop;
+    } else {
+        const int fftOrder = config.settings.fftOrder;
+        const int fftSize = 1 << fftOrder;
+
+        if (fft_ == nullptr || fft_->getSize() != fftSize) {
+            fft_ = std::make_unique<juce::dsp::FFT>(fftOrder);
+            window_.resize(static_cast<std::size_t>(fftSize));
+            juce::dsp::WindowingFunction<float>::fillWindowingTables(
+                window_.data(), window_.size(), juce::dsp::WindowingFunction<float>::hann, true);
+            fftBuffer_.assign(static_cast<std::size_t>(fftSize) * 2, 0.0f);
+            framePower_.assign(static_cast<std::size_t>(fftSize / 2 + 1), 0.0f);
+        }
+
+        frequenciesHz_.resize(framePower_.size());
+        for (std::size_t bin = 0; bin < frequenciesHz_.size(); ++bin)
+            frequenciesHz_[bin] = static_cast<float>(static_cast<double>(bin) * config.sampleRate / fftSize);
+    }
+
+    smoother_.prepare(frequenciesHz_, config.settings.smoothingOctaveFraction);
+    spectrumPower_.assign(frequenciesHz_.size(), 0.0f);
+    smoothedPower_.assign(frequenciesHz_.size(), 0.0f);
+    componentPower_.assign(frequenciesHz_.size(), 0.0f);
+    prepareSpectrogramGrid();
+
+    resetChannel(pre_);
+    resetChannel(post_);
+    samplesSincePeakUpdate_ = 0;
+    publishedSilence_ = false;
+    configured_ = true;
+}
+
+void SpectrumAnalyzer::resetChannel(Channel& channel) const {
+    const auto& settings = activeConfig_.settings;
+    channel.peakDb.assign(settings.peakHold ? frequenciesHz_.size() : 0, MinDb);
+    channel.hasNewFrame = false;
+
+    if (settings.multiResolution) {
+        for (auto& analyzer : channel.multiResolution)
+            analyzer.reset();
+        channel.averagePower.assign(frequenciesHz_.size(), 0.0f);
+        return;
+    }
+
+    const auto numBins = framePower_.size();
+    channel.averagePower.assign(numBins, 0.0f);
+    channel.welchFrames.assign(
+        settings.averaging == Averaging::Welch ? numBins * static_cast<std::size_t>(settings.averagingFrames) : 0,
+        0.0f);
+    channel.welchIndex = 0;
+    channel.welchCount = 0;
+    channel.framesAnalysed = 0;
+}
+
+void SpectrumAnalyzer::pushMultiResolution() {
+    const int numReady = fifo_.getNumReady();
+    if (numReady <= 0)
+        return;
+
+    const bool spectrogram = activeConfig_.settings.view == View::Spectrogram;
+
+    // Each stage runs a 256-point FFT per 128 of its own samples, so even a long backlog is cheap to catch up on.
+    const auto region = fifo_.prepareRead(numReady);
+    auto pushRun = [&](int start, int size) {
+        for (int offset = 0; offset < size; offset += SourceBlockSize) {
+            const int numSamples = juce::jmin(SourceBlockSize, size - offset);
+
+            for (auto* channel : {&pre_, &post_}) {
+                const float* left = fifo_.getPlane(channel->leftPlane) + start + offset;
+                const float* right = fifo_.getPlane(channel->rightPlane) + start + offset;
+
+                for (int c = 0; c < components_.count; ++c) {
+                    auto& analyzer = channel->multiResolution[static_cast<std::size_t>(c)];
+                    deriveComponent(components_.items[static_cast<std::size_t>(c)], left, right, sourceBlock_.data(),
+                                    numSamples);
+                    channel->hasNewFrame = analyzer.push(sourceBlock_.data(), numSamples) || channel->hasNewFrame;
+                }
+            }
+
+            if (spectrogram) {
+                samplesUntilSpectrogramLine_ -= numSamples;
+                if (samplesUntilSpectrogramLine_ <= 0) {
+                    samplesUntilSpectrogramLine_ += MultiResolutionLineHop;
+                    gatherMultiResolutionPower(post_, spectrumPower_.data());
+                    pushSpectrogramLine(spectrumPower_.data());
+                }
+            }
         }
+    };
+
+    pushRun(region.start1, region.size1);
+    pushRun(region.start2, region.size2);
+
+    fifo_.finishRead(region.getTotalSize());
+    samplesSincePeakUpdate_ += region.getTotalSize();
+}
+
+void SpectrumAnalyzer::analyseReadyFrames() {
+    const int fftSize = fft_->getSize();
+    const int hopSize = getHopSize(activeConfig_.settings, fftSize);
+
+    // Frames are read straight out of the FIFO: the read index only advances by one hop per frame, so the overlap
+    // for the next frame stays in the ring instead of in a per-channel history copy.
+    int numReady = fifo_.getNumReady();
+    if (numReady < fftSize)
+        return;
+
+    // After a stall (editor hidden, UI busy) the FIFO can hold many hops. Skip all but the most recent frames so
+    // one run stays short and the averages stay current.
+    const int framesReady = (numReady - fftSize) / hopSize + 1;
+    if (framesReady > MaxFramesPerRun) {
+        const int skipped = (framesReady - MaxFramesPerRun) * hopSize;
+        fifo_.finishRead(skipped);
+        samplesSincePeakUpdate_ += skipped;
+        numReady -= skipped;
     }
 
-    while (true) {
-        const int numRead = processor_.popPostAnalyzerSamples(temp.data(), TempBlockSize);
-        if (numRead <= 0)
+    for (; numReady >= fftSize; numReady -= hopSize) {
+        const auto region = fifo_.prepareRead(fftSize);
+        analyseFrame(pre_, region);
+        analyseFrame(post_, region);
+        // The waterfall shows each hop's own frame, unaveraged, so it keeps the full time resolution.
+        if (activeConfig_.settings.view == View::Spectrogram)
+            pushSpectrogramLine(framePower_.data());
+        fifo_.finishRead(hopSize);
+        samplesSincePeakUpdate_ += hopSize;
+    }
+}
+
+SpectrumAnalyzer::Components SpectrumAnalyzer::resolveComponents() const noexcept {
+    auto source = activeConfig_.settings.source;
+
+    if (source == Source::BankA || source == Source::BankB) {
+        const bool bankA = source == Source::BankA;
+        switch (processor_.params().getStereoMode()) {
+        case util::StereoMode::LeftRight:
+            source = bankA ? Source::Left : Source::Right;
+            break;
+        case util::StereoMode::MidSide:
+            source = bankA ? Source::Mid : Source::Side;
             break;
+        case util::StereoMode::Stereo:
+            source = Source::Sum;
+            break;
+        }
+    }
+
+    switch (source) {
+    case Source::Left:
+        return {{Component::Left}, 1};
+    case Source::Right:
+        return {{Component::Right}, 1};
+    case Source::Mid:
+        return {{Component::Mid}, 1};
+    case Source::Side:
+        return {{Component::Side}, 1};
+    case Source::Sum:
+    case Source::BankA:
+    case Source::BankB:
+        break;
+    }
+
+    return {{Component::Left, Component::Right}, 2};
+}
+
+void SpectrumAnalyzer::analyseFrame(Channel& channel, util::RingRegion region) {
+    const auto& settings = activeConfig_.settings;
+    const int numBins = static_cast<int>(framePower_.size());
+
+    transformComponent(channel, components_.items[0], region, false);
+    if (components_.count == 2) {
+        transformComponent(channel, components_.items[1], region, true);
+        juce::FloatVectorOperations::multiply(framePower_.data(), 0.5f, numBins);
+    }
+
+    auto* average = channel.averagePower.data();
+    const auto* frame = framePower_.data();
+
+    switch (settings.averaging) {
+    case Averaging::Off:
+        juce::FloatVectorOperations::copy(average, frame, numBins);
+        break;
+    case Averaging::Exponential: {
+        // Starts as a plain mean so the first few hops are not pulled towards silence.
+        const int effectiveFrames = juce::jmin(channel.framesAnalysed + 1, settings.averagingFrames);
+        const float weight = 1.0f / static_cast<float>(effectiveFrames);
+        juce::FloatVectorOperations::multiply(average, 1.0f - weight, numBins);
+        juce::FloatVectorOperations::addWithMultiply(average, frame, weight, numBins);
+        break;
+    }
+    case Averaging::Welch: {
+        // Running sum over the last `averagingFrames` overlapped segments.
+        auto* slot = channel.welchFrames.data() + static_cast<std::size_t>(channel.welchIndex * numBins);
+        if (channel.welchCount == settings.averagingFrames)
+            juce::FloatVectorOperations::subtract(average, slot, numBins);
+        else
+            ++channel.welchCount;
+
+        juce::FloatVectorOperations::copy(slot, frame, numBins);
+        juce::FloatVectorOperations::add(average, frame, numBins);
+        channel.welchIndex = (channel.welchIndex + 1) % settings.averagingFrames;
+        break;
+    }
+    }
+
+    ++channel.framesAnalysed;
+    channel.hasNewFrame = true;
+}
+
+void SpectrumAnalyzer::transformComponent(const Channel& channel, Component component, util::RingRegion region,
+                                          bool accumulate) {
+    const float* left = fifo_.getPlane(channel.leftPlane);
+    const float* right = fifo_.getPlane(channel.rightPlane);
+    const int fftSize = fft_->getSize();
+    const int numBins = static_cast<int>(framePower_.size());
+    float* input = fftBuffer_.data();
+
+    if (component == Component::Left || component == Component::Right) {
+        // A single plane is windowed straight out of both runs of the ring region, oldest sample first.
+        const float* samples = component == Component::Left ? left : right;
+        juce::FloatVectorOperations::multiply(input, samples + region.start1, window_.data(), region.size1);
+        juce::FloatVectorOperations::multiply(input + region.size1, samples + region.start2,
+                                              window_.data() + region.size1, region.size2);
+    } else {
+        deriveComponent(component, left + region.start1, right + region.start1, input, region.size1);
+        deriveComponent(component, left + region.start2, right + region.start2, input + region.size1, region.size2);
+        juce::FloatVectorOperations::multiply(input, window_.data(), fftSize);
+    }
+
+    // Real-input transform; only the non-negative half of the spectrum is needed for magnitudes.
+    fft_->performRealOnlyForwardTransform(input, true);
+
+    const float scale = getComponentPowerScale(component) / static_cast<float>(juce::square(fftSize / 2));
+    for (int bin = 0; bin < numBins; ++bin) {
+        const float re = fftBuffer_[static_cast<std::size_t>(bin * 2)];
+        const float im = fftBuffer_[static_cast<std::size_t>(bin * 2 + 1)];
+        const float power = (re * re + im * im) * scale;
+        auto& destination = framePower_[static_cast<std::size_t>(bin)];
+        destination = accumulate ? destination + power : power;
+    }
+}
+
+void SpectrumAnalyzer::deriveComponent(Component component, const float* left, const float* right, float* destination,
+                                       int numSamples) noexcept {
+    // Mid and side are left as L + R and L - R; the 1/2 is folded into getComponentPowerScale().
+    switch (component) {
+    case Component::Left:
+        juce::FloatVectorOperations::copy(destination, left, numSamples);
+        break;
+    case Component::Right:
+        juce::FloatVectorOperations::copy(destination, right, numSamples);
+        break;
+    case Component::Mid:
+        juce::FloatVectorOperations::add(destination, left, right, numSamples);
+        break;
+    case Component::Side:
+        juce::FloatVectorOperations::subtract(destination, left, right, numSamples);
+        break;
+    }
+}
+
+float SpectrumAnalyzer::getComponentPowerScale(Component component) noexcept {
+    return component == Component::Mid || component == Component::Side ? 0.25f : 1.0f;
+}
+
+void SpectrumAnalyzer::gatherMultiResolutionPower(const Channel& channel, float* destination) {
+    const auto numPoints = static_cast<int>(frequenciesHz_.size());
+    const int numComponents = components_.count;
+
+    for (int c = 0; c < numComponents; ++c) {
+        float* componentDestination = c == 0 ? destination : componentPower_.data();
+        channel.multiResolution[static_cast<std::size_t>(c)].getPowerSpectrum(componentDestination);
+        const float scale = getComponentPowerScale(components_.items[static_cast<std::size_t>(c)]) /
+                            static_cast<float>(numComponents);
+        juce::FloatVectorOperations::multiply(componentDestination, scale, numPoints);
+    }
+
+    if (numComponents == 2)
+        juce::FloatVectorOperations::add(destination, componentPower_.data(), numPoints);
+}
 
-        for (int i = 0; i < numRead; ++i) {
-            postHistory_[static_cast<std::size_t>(postWritePosition_)] = temp[static_cast<std::size_t>(i)];
-            postWritePosition_ = (postWritePosition_ + 1) % FFTSize;
+void SpectrumAnalyzer::writeSpectrum(const Channel& channel, std::vector<float>& destinationDb) {
+    const auto numPoints = frequenciesHz_.size();
+    destinationDb.resize(numPoints);
+
+    if (activeConfig_.settings.multiResolution) {
+        gatherMultiResolutionPower(channel, spectrumPower_.data());
+    } else {
+        const float scale = activeConfig_.settings.averaging == Averaging::Welch && channel.welchCount > 0
+                                ? 1.0f / static_cast<float>(channel.welchCount)
+                                : 1.0f;
+        juce::FloatVectorOperations::multiply(spectrumPower_.data(), channel.averagePower.data(), scale,
+                                              static_cast<int>(numPoints));
+    }
+
+    // Smooth power rather than dB so that a narrow peak spreads out instead of being pulled down by the floor.
+    const float* power = spectrumPower_.data();
+    if (smoother_.isActive()) {
+        smoother_.process(power, smoothedPower_.data());
+        power = smoothedPower_.data();
+    }
+
+    for (std::size_t point = 0; point < numPoints; ++point)
+        destinationDb[point] = powerToDb(power[point], MinDb, MaxDb);
+}
+
+void SpectrumAnalyzer::prepareSpectrogramGrid() {
+    const auto numPoints = static_cast<int>(frequenciesHz_.size());
+    const double maxFrequency = juce::jmin(activeConfig_.sampleRate * 0.495, 20000.0);
+    const double octaves = std::log2(maxFrequency / static_cast<double>(MinPlotFrequency));
+    const double halfStep = 0.5 * octaves / static_cast<double>(SpectrogramPoints - 1);
+    const auto begin = frequenciesHz_.begin();
+    const auto end = frequenciesHz_.end();
+
+    for (int g = 0; g < SpectrogramPoints; ++g) {
+        const double centre = static_cast<double>(MinPlotFrequency) *
+                              std::exp2(octaves * static_cast<double>(g) / static_cast<double>(SpectrogramPoints - 1));
+        auto first = static_cast<int>(std::lower_bound(begin, end, static_cast<float>(centre * std::exp2(-halfStep))) -
+                                      begin);
+        auto last =
+            static_cast<int>(std::lower_bound(begin, end, static_cast<float>(centre * std::exp2(halfStep))) - begin);
+
+        // Low grid points fall between analysis points; take the nearer neighbour.
+        if (last <= first) {
+            const auto above = static_cast<int>(std::lower_bound(begin, end, static_cast<float>(centre)) - begin);
+            first = juce::jlimit(0, numPoints - 1, above);
+            if (above > 0 && (above == numPoints || centre - frequenciesHz_[static_cast<std::size_t>(above - 1)] <
+                                                        frequenciesHz_[static_cast<std::size_t>(above)] - centre))
+                first = above - 1;
+            last = first + 1;
         }
+
+        spectrogramLower_[static_cast<std::size_t>(g)] = first;
+        spectrogramUpper_[static_cast<std::size_t>(g)] = last;
     }
 }
 
-void SpectrumAnalyzer::buildPathFromHistory(const std::array<float, FFTSize>& history, int writePosition,
-                                            std::array<float, FFTSize * 2>& fftBuffer, juce::Path& path,
-                                            double sampleRate) {
-    for (int i = 0; i < FFTSize; ++i) {
-        const int historyIndex = (writePosition + i) % FFTSize;
-        fftBuffer[static_cast<std::size_t>(i)] = history[static_cast<std::size_t>(historyIndex)];
+void SpectrumAnalyzer::pushSpectrogramLine(const float* power) {
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+    spectrogramFifo_.prepareToWrite(1, start1, size1, start2, size2);
+    // The editor has fallen behind (or is not drawing); drop the line rather than wait.
+    if (size1 == 0)
+        return;
+
+    auto* line = spectrogramLines_.data() + static_cast<std::size_t>(start1) * SpectrogramPoints;
+    for (std::size_t g = 0; g < static_cast<std::size_t>(SpectrogramPoints); ++g) {
+        const int first = spectrogramLower_[g];
+        const float peak = juce::FloatVectorOperations::findMaximum(power + first, spectrogramUpper_[g] - first);
+        const float level = (powerToDb(peak, MinDb, MaxDb) - MinDb) / (MaxDb - MinDb);
+        line[g] = static_cast<std::uint8_t>(juce::roundToInt(level * 255.0f));
     }
 
-    window_.multiplyWithWindowingTable(fftBuffer.data(), FFTSize);
-    std::fill(fftBuffer.begin() + FFTSize, fftBuffer.end(), 0.0f);
-    fft_.performFrequencyOnlyForwardTransform(fftBuffer.data());
+    spectrogramFifo_.finishedWrite(1);
+}
+
+bool SpectrumAnalyzer::isSilent(const Spectra& spectra) noexcept {
+    auto atFloor = [](const std::vector<float>& magnitudeDb) {
+        return std::all_of(magnitudeDb.begin(), magnitudeDb.end(), [](float db) { return db <= MinDb; });
+    };
+
+    return atFloor(spectra.preDb) && atFloor(spectra.postDb) &&
+           (!spectra.hasPeaks || (atFloor(spectra.prePeakDb) && atFloor(spectra.postPeakDb)));
+}
+
+void SpectrumAnalyzer::updatePeaks(Channel& channel, const std::vector<float>& magnitudeDb, float decayDb) const {
+    for (std::size_t bin = 0; bin < channel.peakDb.size(); ++bin)
+        channel.peakDb[bin] = juce::jmax(channel.peakDb[bin] - decayDb, magnitudeDb[bin]);
+}
+
+void SpectrumAnalyzer::rebuildColumns(const std::vector<float>& frequenciesHz, double sampleRate) {
+    columnFrequencies_ = frequenciesHz;
+    columns_.clear();
+
+    const int numPoints = static_cast<int>(frequenciesHz.size());
+    const int numColumns = juce::roundToInt(bounds_.getWidth());
+    if (numPoints < 2 || numColumns < 2)
+        return;
 
     const float maxFrequency = static_cast<float>(juce::jmin(sampleRate * 0.495, 20000.0));
-    path.clear();
+    const float columnWidth = bounds_.getWidth() / static_cast<float>(numColumns);
+    columns_.resize(static_cast<std::size_t>(numColumns));
 
-    bool started = false;
-    for (int bin = 1; bin < FFTSize / 2; ++bin) {
-        const float frequency =
-            (static_cast<float>(bin) * static_cast<float>(sampleRate)) / static_cast<float>(FFTSize);
-        if (frequency < 20.0f || frequency > maxFrequency)
-            continue;
+    int point = 0;
+    for (int c = 0; c < numColumns; ++c) {
+        const float lowHz = normalizedToFrequency(static_cast<float>(c) / static_cast<float>(numColumns), maxFrequency);
+        const float highHz =
+            normalizedToFrequency(static_cast<float>(c + 1) / static_cast<float>(numColumns), maxFrequency);
+
+        while (point < numPoints && frequenciesHz[static_cast<std::size_t>(point)] < lowHz)
+            ++point;
+        int end = point;
+        while (end < numPoints && frequenciesHz[static_cast<std::size_t>(end)] < highHz)
+            ++end;
+
+        auto& column = columns_[static_cast<std::size_t>(c)];
+        column.x = bounds_.getX() + (static_cast<float>(c) + 0.5f) * columnWidth;
+        column.begin = point;
+        column.end = end;
+        column.fraction = 0.0f;
+
+        if (end == point) {
+            const int lower = juce::jlimit(0, numPoints - 2, point - 1);
+            const float centreHz =
+                normalizedToFrequency((static_cast<float>(c) + 0.5f) / static_cast<float>(numColumns), maxFrequency);
+            const float logLower = std::log(juce::jmax(frequenciesHz[static_cast<std::size_t>(lower)], 1.0e-3f));
+            const float logUpper = std::log(juce::jmax(frequenciesHz[static_cast<std::size_t>(lower + 1)], 1.0e-3f));
+
+            column.begin = lower;
+            column.end = lower;
+            column.fraction = juce::jlimit(0.0f, 1.0f, (std::log(centreHz) - logLower) /
+                                                           juce::jmax(logUpper - logLower, 1.0e-6f));
+        }
+
+        point = end;
+    }
+}
+
+void SpectrumAnalyzer::buildPath(const std::vector<float>& magnitudeDb, juce::Path& path) const {
+    path.clear();
+    if (columns_.empty() || magnitudeDb.size() < columnFrequencies_.size())
+        return;
 
-        const float magnitude = fftBuffer[static_cast<std::size_t>(bin)] / static_cast<float>(FFTSize / 2);
-        const float db = juce::jlimit(minDb_, maxDb_, juce::Decibels::gainToDecibels(magnitude, minDb_));
+    const bool mean = settings_.columnReduction == ColumnReduction::Mean;
+    const float* db = magnitudeDb.data();
 
-        const float x = frequencyToX(frequency, bounds_, maxFrequency);
-        const float y = dbToY(db, bounds_, minDb_, maxDb_);
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+        const auto& column = columns_[c];
+        const int count = column.end - column.begin;
 
-        if (!started) {
-            path.startNewSubPath(x, y);
-            started = true;
+        float value = 0.0f;
+        if (count == 0) {
+            value = db[column.begin] + column.fraction * (db[column.begin + 1] - db[column.begin]);
+        } else if (mean) {
+            // Mean of the dB values: a display average, not a power sum.
+            float sum = 0.0f;
+            for (int point = column.begin; point < column.end; ++point)
+                sum += db[point];
+            value = sum / static_cast<float>(count);
         } else {
-            path.lineTo(x, y);
+            value = juce::FloatVectorOperations::findMaximum(db + column.begin, count);
         }
+
+        const float y = dbToY(value, bounds_, MinDb, MaxDb);
+        if (c == 0)
+            path.startNewSubPath(column.x, y);
+        else
+            path.lineTo(column.x, y);
+    }
+}
+
+bool SpectrumAnalyzer::updateSpectrogram() {
+    const int width = juce::roundToInt(bounds_.getWidth());
+    const int height = juce::roundToInt(bounds_.getHeight());
+    if (spectrogramImage_.getWidth() != width || spectrogramImage_.getHeight() != height) {
+        spectrogramImage_ = juce::Image(juce::Image::ARGB, width, height, true);
+        spectrogramRow_ = 0;
+        spectrogramPositions_.resize(static_cast<std::size_t>(width));
+        for (int x = 0; x < width; ++x) {
+            spectrogramPositions_[static_cast<std::size_t>(x)] =
+                (static_cast<float>(x) + 0.5f) / static_cast<float>(width) * static_cast<float>(SpectrogramPoints - 1);
+        }
+    }
+
+    int linesReady = spectrogramFifo_.getNumReady();
+    if (linesReady == 0)
+        return false;
+
+    // Anything beyond one image height would be overwritten before it is ever shown.
+    if (linesReady > height) {
+        spectrogramFifo_.finishedRead(linesReady - height);
+        linesReady = height;
+    }
+
+    for (int i = 0; i < linesReady; ++i) {
+        int start1 = 0;
+        int size1 = 0;
+        int start2 = 0;
+        int size2 = 0;
+        spectrogramFifo_.prepareToRead(1, start1, size1, start2, size2);
+        writeSpectrogramRow(spectrogramLines_.data() + static_cast<std::size_t>(start1) * SpectrogramPoints);
+        spectrogramFifo_.finishedRead(1);
+    }
+
+    return true;
+}
+
+void SpectrumAnalyzer::writeSpectrogramRow(const std::uint8_t* line) {
+    // Stepping the ring upwards keeps the rows from spectrogramRow_ onwards in newest-to-oldest order.
+    const int height = spectrogramImage_.getHeight();
+    spectrogramRow_ = (spectrogramRow_ == 0 ? height : spectrogramRow_) - 1;
+
+    const int width = spectrogramImage_.getWidth();
+    const juce::Image::BitmapData bitmap(spectrogramImage_, 0, spectrogramRow_, width, 1,
+                                         juce::Image::BitmapData::writeOnly);
+    for (int x = 0; x < width; ++x) {
+        const float position = spectrogramPositions_[static_cast<std::size_t>(x)];
+        const auto lower = static_cast<std::size_t>(position);
+        const float fraction = position - static_cast<float>(lower);
+        const float level = static_cast<float>(line[lower]) +
+                            fraction * (static_cast<float>(line[lower + 1]) - static_cast<float>(line[lower]));
+        *reinterpret_cast<juce::PixelARGB*>(bitmap.getPixelPointer(x, 0)) =
+            spectrogramPalette_[static_cast<std::size_t>(juce::roundToInt(level))];
     }
 }
 
+void SpectrumAnalyzer::clearSpectrogram() {
+    spectrogramImage_ = {};
+    spectrogramFifo_.finishedRead(spectrogramFifo_.getNumReady());
+}
+
+void SpectrumAnalyzer::drawSpectrogram(juce::Graphics& g) const {
+    if (spectrogramImage_.isNull())
+        return;
+
+    // Two blits unroll the ring: the rows from the newest to the bottom of the image, then the wrapped remainder.
+    const int x = juce::roundToInt(bounds_.getX());
+    const int y = juce::roundToInt(bounds_.getY());
+    const int width = spectrogramImage_.getWidth();
+    const int height = spectrogramImage_.getHeight();
+    const int newestRows = height - spectrogramRow_;
+
+    g.drawImage(spectrogramImage_, x, y, width, newestRows, 0, spectrogramRow_, width, newestRows);
+    if (spectrogramRow_ > 0)
+        g.drawImage(spectrogramImage_, x, y + newestRows, width, spectrogramRow_, 0, 0, width, spectrogramRow_);
+}
+
 } // namespace ui
@@ -1,46 +1,227 @@
 #pragma once
 
+#include "../dsp/MultiResolutionAnalyzer.h"
+#include "../dsp/OctaveSmoother.h"
+#include "../util/AnalyzerFifo.h"
+#include "../util/TripleBuffer.h"
+#include "AnalysisScheduler.h"
+#include <array>
+#include <cstdint>
 #include <juce_dsp/juce_dsp.h>
 #include <juce_gui_basics/juce_gui_basics.h>
+#include <memory>
+#include <vector>
 
 class EQInfinityAudioProcessor;
 
 namespace ui {
 
-class SpectrumAnalyzer {
+// Pre/post EQ spectrum overlay. The FFTs run on the shared AnalysisScheduler pool; the message thread only turns
+// the latest published spectra into paths.
+//
+// Analysis is hop-driven: one FFT per `hop` new samples, however often the editor asks, so the cost follows the
+// audio rate rather than the frame rate and nothing is recomputed while the input is silent or stopped.
+//
+// In multi-resolution mode each signal goes through a ::dsp::MultiResolutionAnalyzer instead of one large FFT, which
+// resolves the low octaves finely without smearing transients at the top. FFT size and overlap are ignored there, and
+// Welch averaging falls back to exponential averaging.
+//
+// Spectra are optionally 1/N-octave smoothed on the pool thread, then reduced to one point per pixel column when the
+// paths are built: dense high bins collapse to their max (or mean) and sparse low bins are interpolated.
+//
+// Each tap carries left and right; the displayed source (L, R, M, S, their power sum or the signal a bank processes)
+// is derived per frame on the pool thread.
+//
+// The spectrogram view is a waterfall on the plot's frequency axis. Each hop the pool thread reduces the post-EQ
+// spectrum to a fixed log grid of 8-bit levels and queues it; the message thread writes every queued line as one pixel
+// row of a ring image and draws the ring with two blits, so the cost per hop is one row whatever the plot size.
+class SpectrumAnalyzer final : private AnalysisScheduler::Client {
   public:
+    enum class Overlap { Percent50, Percent75 };
+    enum class Averaging { Off, Exponential, Welch };
+    enum class ColumnReduction { Max, Mean };
+    // Sum averages the L and R powers, so unlike Mid it does not cancel out-of-phase content. BankA/BankB follow
+    // the stereo mode: L/R or M/S for the bank's channel, or Sum when bank A processes both.
+    enum class Source { Left, Right, Sum, Mid, Side, BankA, BankB };
+    enum class View { Spectrum, Spectrogram };
+
+    struct Settings {
+        static constexpr int MinFFTOrder = 10;
+        static constexpr int MaxFFTOrder = 15;
+
+        int fftOrder = 11;
+        Overlap overlap = Overlap::Percent75;
+        Averaging averaging = Averaging::Exponential;
+        // Welch: number of overlapped segments averaged. Exponential: equivalent time constant in hops.
+        int averagingFrames = 4;
+        bool peakHold = false;
+        bool multiResolution = false;
+        // N in 1/N octave smoothing; 0 is off.
+        int smoothingOctaveFraction = 0;
+        ColumnReduction columnReduction = ColumnReduction::Max;
+        Source source = Source::Sum;
+        View view = View::Spectrum;
+
+        [[nodiscard]] bool operator==(const Settings& other) const noexcept {
+            return fftOrder == other.fftOrder && overlap == other.overlap && averaging == other.averaging &&
+                   averagingFrames == other.averagingFrames && peakHold == other.peakHold &&
+                   multiResolution == other.multiResolution &&
+                   smoothingOctaveFraction == other.smoothingOctaveFraction &&
+                   columnReduction == other.columnReduction && source == other.source && view == other.view;
+        }
+        [[nodiscard]] bool operator!=(const Settings& other) const noexcept { return !(*this == other); }
+    };
+
     explicit SpectrumAnalyzer(EQInfinityAudioProcessor& processor);
+    ~SpectrumAnalyzer() override;
 
-    void update(double sampleRate, juce::Rectangle<float> plotBounds);
+    // Message thread: rebuilds the paths from the newest spectra and schedules the next analysis. Returns true when
+    // the paths changed and the plot needs repainting.
+    bool update(double sampleRate, juce::Rectangle<float> plotBounds);
     void draw(juce::Graphics& g) const;
 
+    // Message thread. Changing the FFT size or averaging restarts the averages.
+    void setSettings(const Settings& settings);
+    [[nodiscard]] const Settings& getSettings() const noexcept { return settings_; }
+
   private:
-    static constexpr int FFTOrder = 11;
-    static constexpr int FFTSize = 1 << FFTOrder;
-    static constexpr int TempBlockSize = 512;
+    static constexpr int MaxFramesPerRun = 8;
+    static constexpr int SourceBlockSize = 512;
+    static constexpr float MinDb = -96.0f;
+    static constexpr float MaxDb = 12.0f;
+    static constexpr float PeakDecayDbPerSecond = 6.0f;
+    // Log-spaced points per spectrogram line, over the same 20 Hz to Nyquist-or-20 kHz range as the plot.
+    static constexpr int SpectrogramPoints = 512;
+    // Lines queued between the pool and the message thread; more than a second of hops at typical settings.
+    static constexpr int SpectrogramCapacity = 256;
+    // The multi-resolution cascade has no single hop, so its waterfall advances every this many input samples.
+    static constexpr int MultiResolutionLineHop = 1024;
+
+    struct Config {
+        Settings settings;
+        double sampleRate = 44100.0;
+    };
+
+    struct Spectra {
+        // Frequency of each value in the dB vectors: FFT bin centres, or the log grid in multi-resolution mode.
+        std::vector<float> frequenciesHz;
+        std::vector<float> preDb;
+        std::vector<float> postDb;
+        std::vector<float> prePeakDb;
+        std::vector<float> postPeakDb;
+        bool hasPeaks = false;
+    };
+
+    // One pixel column of the plot. Either the points in [begin, end) land in it, or (begin == end) it lies between
+    // points `begin` and `begin + 1` and is interpolated in log frequency.
+    struct Column {
+        float x = 0.0f;
+        int begin = 0;
+        int end = 0;
+        float fraction = 0.0f;
+    };
+
+    // A signal derived from a tap's planes. A Source resolves to one component, or two whose powers are averaged.
+    enum class Component { Left, Right, Mid, Side };
+
+    struct Components {
+        std::array<Component, 2> items{};
+        int count = 1;
+    };
+
+    // Pool-thread state for one analysed tap.
+    struct Channel {
+        int leftPlane = 0;
+        int rightPlane = 0;
+        std::vector<float> averagePower;
+        std::vector<float> welchFrames;
+        std::vector<float> peakDb;
+        int welchIndex = 0;
+        int welchCount = 0;
+        int framesAnalysed = 0;
+        bool hasNewFrame = false;
+        std::array<::dsp::MultiResolutionAnalyzer, 2> multiResolution;
+    };
 
     EQInfinityAudioProcessor& processor_;
-    juce::dsp::FFT fft_;
-    juce::dsp::WindowingFunction<float> window_;
+    // Attached for the analyzer's lifetime; the processor only feeds it while at least one analyzer exists.
+    util::AnalyzerFifo<4>& fifo_;
+    juce::SharedResourcePointer<AnalysisScheduler> scheduler_;
+    util::TripleBuffer<Config> config_;
+    util::TripleBuffer<Spectra> spectra_;
 
-    std::array<float, FFTSize> preHistory_{};
-    std::array<float, FFTSize> postHistory_{};
-    int preWritePosition_ = 0;
-    int postWritePosition_ = 0;
+    // Pool thread only.
+    Config activeConfig_;
+    bool configured_ = false;
+    std::unique_ptr<juce::dsp::FFT> fft_;
+    std::vector<float> window_;
+    std::vector<float> fftBuffer_;
+    std::vector<float> framePower_;
+    std::vector<float> frequenciesHz_;
+    ::dsp::OctaveSmoother smoother_;
+    std::vector<float> spectrumPower_;
+    std::vector<float> smoothedPower_;
+    std::vector<float> componentPower_;
+    std::array<float, SourceBlockSize> sourceBlock_{};
+    Components components_;
+    int samplesSincePeakUpdate_ = 0;
+    int samplesUntilSpectrogramLine_ = 0;
+    // Per spectrogram point: the half-open range of analysis points reduced into it.
+    std::array<int, SpectrogramPoints> spectrogramLower_{};
+    std::array<int, SpectrogramPoints> spectrogramUpper_{};
+    // True while the last published spectra sat at the floor everywhere; further silent frames are not published.
+    bool publishedSilence_ = false;
+    Channel pre_;
+    Channel post_;
 
-    std::array<float, FFTSize * 2> preFftBuffer_{};
-    std::array<float, FFTSize * 2> postFftBuffer_{};
+    // Spectrogram lines, written by the pool thread and read by the message thread.
+    juce::AbstractFifo spectrogramFifo_{SpectrogramCapacity};
+    std::vector<std::uint8_t> spectrogramLines_;
 
+    // Message thread only.
+    Settings settings_;
+    double configSampleRate_ = 0.0;
     juce::Path prePath_;
     juce::Path postPath_;
+    juce::Path prePeakPath_;
+    juce::Path postPeakPath_;
     juce::Rectangle<float> bounds_;
+    std::vector<Column> columns_;
+    std::vector<float> columnFrequencies_;
+    double pathSampleRate_ = 0.0;
+    bool hasSpectra_ = false;
+    bool pathsDirty_ = false;
+    // Ring of plot-sized rows; the newest row is spectrogramRow_, older ones follow it downwards and wrap.
+    juce::Image spectrogramImage_;
+    int spectrogramRow_ = 0;
+    // Per image column: fractional position on the spectrogram grid.
+    std::vector<float> spectrogramPositions_;
+    std::array<juce::PixelARGB, 256> spectrogramPalette_{};
 
-    float minDb_ = -96.0f;
-    float maxDb_ = 12.0f;
-
-    void pullFromProcessor();
-    void buildPathFromHistory(const std::array<float, FFTSize>& history, int writePosition,
-                              std::array<float, FFTSize * 2>& fftBuffer, juce::Path& path, double sampleRate);
+    void publishConfig(double sampleRate);
+    void runAnalysis() override;
+    void configure(const Config& config);
+    void resetChannel(Channel& channel) const;
+    void pushMultiResolution();
+    void analyseReadyFrames();
+    Components resolveComponents() const noexcept;
+    void analyseFrame(Channel& channel, util::RingRegion region);
+    void transformComponent(const Channel& channel, Component component, util::RingRegion region, bool accumulate);
+    static void deriveComponent(Component component, const float* left, const float* right, float* destination,
+                                int numSamples) noexcept;
+    static float getComponentPowerScale(Component component) noexcept;
+    void gatherMultiResolutionPower(const Channel& channel, float* destination);
+    void writeSpectrum(const Channel& channel, std::vector<float>& destinationDb);
+    void prepareSpectrogramGrid();
+    void pushSpectrogramLine(const float* power);
+    [[nodiscard]] static bool isSilent(const Spectra& spectra) noexcept;
+    void updatePeaks(Channel& channel, const std::vector<float>& magnitudeDb, float decayDb) const;
+    void rebuildColumns(const std::vector<float>& frequenciesHz, double sampleRate);
+    void buildPath(const std::vector<float>& magnitudeDb, juce::Path& path) const;
+    bool updateSpectrogram();
+    void writeSpectrogramRow(const std::uint8_t* line);
+    void clearSpectrogram();
+    void drawSpectrogram(juce::Graphics& g) const;
 };
 
 } // namespace ui
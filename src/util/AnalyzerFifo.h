@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <juce_core/juce_core.h>
+#include <vector>
+
+namespace util {
+
+// Up to two contiguous runs of a ring buffer; the second is empty unless the region wraps.
+struct RingRegion {
+    int start1 = 0;
+    int size1 = 0;
+    int start2 = 0;
+    int size2 = 0;
+
+    [[nodiscard]] int getTotalSize() const noexcept { return size1 + size2; }
+};
+
+// Single-producer / single-consumer sample FIFO with `NumPlanes` parallel signals sharing one read and one write
+// index. The writer reserves a block, fills each plane and publishes them together; the reader works directly on
+// the ring regions (no copy out) and decides how far to advance, so it can leave overlap behind for the next frame.
+template <int NumPlanes> class AnalyzerFifo {
+  public:
+    static constexpr int Capacity = 1 << 16;
+
+    AnalyzerFifo() : fifo_(Capacity), storage_(static_cast<std::size_t>(Capacity) * NumPlanes, 0.0f) {}
+
+    [[nodiscard]] static constexpr std::size_t getMemoryFootprintBytes() noexcept {
+        return sizeof(AnalyzerFifo) + sizeof(float) * static_cast<std::size_t>(Capacity) * NumPlanes;
+    }
+
+    // Any thread: asks the reader to drop whatever is ready the next time it calls getNumReady(). Unlike resetting
+    // the indices, this is safe while a reader is in the middle of a frame.
+    void requestDiscard() noexcept { discardRequested_.store(true, std::memory_order_release); }
+
+    // Writer: reserves room for up to `numSamples` per plane and returns how many fit. Samples that do not fit are
+    // dropped from every plane alike, so the planes stay aligned.
+    int beginWrite(int numSamples) noexcept {
+        pending_ = {};
+        if (numSamples > 0)
+            fifo_.prepareToWrite(numSamples, pending_.start1, pending_.size1, pending_.start2, pending_.size2);
+
+        return pending_.getTotalSize();
+    }
+
+    // Writer: fills one plane of the reserved block. nullptr writes silence.
+    void writePlane(int plane, const float* samples) noexcept {
+        float* destination = getPlaneData(plane);
+        if (samples == nullptr) {
+            juce::FloatVectorOperations::clear(destination + pending_.start1, pending_.size1);
+            juce::FloatVectorOperations::clear(destination + pending_.start2, pending_.size2);
+            return;
+        }
+
+        juce::FloatVectorOperations::copy(destination + pending_.start1, samples, pending_.size1);
+        juce::FloatVectorOperations::copy(destination + pending_.start2, samples + pending_.size1, pending_.size2);
+    }
+
+    // Writer: publishes the reserved block of every plane with a single index update.
+    void finishWrite() noexcept {
+        fifo_.finishedWrite(pending_.getTotalSize());
+        pending_ = {};
+    }
+
+    // Reader. Honours a pending requestDiscard() first.
+    [[nodiscard]] int getNumReady() noexcept {
+        if (discardRequested_.exchange(false, std::memory_order_acquire))
+            fifo_.finishedRead(fifo_.getNumReady());
+
+        return fifo_.getNumReady();
+    }
+
+    [[nodiscard]] RingRegion prepareRead(int numSamples) const noexcept {
+        RingRegion region;
+        fifo_.prepareToRead(numSamples, region.start1, region.size1, region.start2, region.size2);
+        return region;
+    }
+
+    [[nodiscard]] const float* getPlane(int plane) const noexcept {
+        return storage_.data() + static_cast<std::size_t>(plane) * Capacity;
+    }
+
+    void finishRead(int numSamples) noexcept { fifo_.finishedRead(numSamples); }
+
+  private:
+    juce::AbstractFifo fifo_;
+    std::vector<float> storage_;
+    // Writer only: the block reserved by beginWrite().
+    RingRegion pending_;
+    std::atomic<bool> discardRequested_{false};
+
+    float* getPlaneData(int plane) noexcept { return storage_.data() + static_cast<std::size_t>(plane) * Capacity; }
+};
+
+} // namespace util
@@ -0,0 +1,41 @@
+#include "LegacySlopeForwarder.h"
+
+namespace util {
+
+LegacySlopeForwarder::LegacySlopeForwarder(Params& params) : params_(params) {
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        for (const auto bank : {Bank::A, Bank::B}) {
+            auto& legacySlope = *params_.handle(i, bank, BandField::Slope);
+            const auto index = static_cast<std::size_t>(legacySlope.getParameterIndex());
+            if (routes_.size() <= index)
+                routes_.resize(index + 1);
+
+            routes_[index] = {&legacySlope, params_.handle(i, bank, BandField::CutSlope)};
+            legacySlope.addListener(this);
+        }
+    }
+}
+
+LegacySlopeForwarder::~LegacySlopeForwarder() {
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        params_.handle(i, Bank::A, BandField::Slope)->removeListener(this);
+        params_.handle(i, Bank::B, BandField::Slope)->removeListener(this);
+    }
+}
+
+void LegacySlopeForwarder::parameterValueChanged(int parameterIndex, float newValue) {
+    if (suspended_.load() || parameterIndex < 0 || parameterIndex >= static_cast<int>(routes_.size()))
+        return;
+
+    const auto& route = routes_[static_cast<std::size_t>(parameterIndex)];
+    if (route.cutSlope == nullptr)
+        return;
+
+    const int legacyIndex = juce::roundToInt(route.legacySlope->convertFrom0to1(newValue));
+    const float slopeIndex = static_cast<float>(Params::slopeIndexForLegacySlope(legacyIndex));
+    const float normalisedValue = route.cutSlope->convertTo0to1(slopeIndex);
+    if (route.cutSlope->getValue() != normalisedValue)
+        route.cutSlope->setValueNotifyingHost(normalisedValue);
+}
+
+} // namespace util
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Params.h"
+#include <atomic>
+#include <vector>
+
+namespace util {
+
+// Keeps automation written against the first release's slope parameters working: a change to a band's legacy
+// 12/24/36/48 dB/oct slope is copied to its cut slope, which is what the band runs. Nothing flows back, so the legacy
+// parameter keeps whatever a host last wrote to it. Like LinkMirror it listens on the parameter objects themselves,
+// so it applies with the editor closed and on whichever thread the host automates from.
+class LegacySlopeForwarder final : private juce::AudioProcessorParameter::Listener {
+  public:
+    explicit LegacySlopeForwarder(Params& params);
+    ~LegacySlopeForwarder() override;
+
+    // While suspended nothing is forwarded, e.g. while a saved state, which holds both slopes, is being restored.
+    void setSuspended(bool shouldBeSuspended) noexcept { suspended_.store(shouldBeSuspended); }
+
+  private:
+    struct Route {
+        juce::RangedAudioParameter* legacySlope = nullptr;
+        juce::RangedAudioParameter* cutSlope = nullptr;
+    };
+
+    Params& params_;
+    // Indexed by parameter index; empty for everything but the legacy slopes.
+    std::vector<Route> routes_;
+    std::atomic<bool> suspended_{false};
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+};
+
+} // namespace util
@@ -0,0 +1,114 @@
+#include "LinkMirror.h"
+
+namespace util {
+namespace {
+
+void mirrorValue(juce::RangedAudioParameter& destination, float normalisedValue) {
+    // The write echoes back through the counterpart's listener. A value that does not survive snapping and skewing
+    // unchanged never compares equal, so the echo is cut here rather than by the comparison. Automation can arrive on
+    // several threads at once, hence one flag per thread.
+    thread_local bool mirroring = false;
+    if (mirroring)
+        return;
+
+    // Both banks share ranges, so equal normalised values are equal values.
+    if (destination.getValue() != normalisedValue) {
+        const juce::ScopedValueSetter<bool> guard(mirroring, true);
+        destination.setValueNotifyingHost(normalisedValue);
+    }
+}
+
+} // namespace
+
+LinkMirror::LinkMirror(Params& params) : params_(params) {
+    auto& editTarget = params_.getEditTargetParameter();
+    editTargetIndex_ = editTarget.getParameterIndex();
+    editTarget.addListener(this);
+
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        for (int f = 0; f < Params::NumBandFields; ++f) {
+            const auto field = static_cast<BandField>(f);
+            auto& a = *params_.handle(i, Bank::A, field);
+            auto& b = *params_.handle(i, Bank::B, field);
+
+            const auto size = static_cast<std::size_t>(juce::jmax(a.getParameterIndex(), b.getParameterIndex()) + 1);
+            if (counterparts_.size() < size)
+                counterparts_.resize(size, nullptr);
+
+            counterparts_[static_cast<std::size_t>(a.getParameterIndex())] = &b;
+            counterparts_[static_cast<std::size_t>(b.getParameterIndex())] = &a;
+            a.addListener(this);
+            b.addListener(this);
+        }
+    }
+
+    mirroredGestures_.resize(counterparts_.size(), false);
+}
+
+LinkMirror::~LinkMirror() {
+    params_.getEditTargetParameter().removeListener(this);
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        for (int f = 0; f < Params::NumBandFields; ++f) {
+            params_.handle(i, Bank::A, static_cast<BandField>(f))->removeListener(this);
+            params_.handle(i, Bank::B, static_cast<BandField>(f))->removeListener(this);
+        }
+    }
+}
+
+void LinkMirror::synchronise() {
+    if (!suspended_.load() && params_.getEditTarget() == EditTarget::Link)
+        copyBankAToB();
+}
+
+void LinkMirror::copyBankAToB() {
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        for (int f = 0; f < Params::NumBandFields; ++f) {
+            const auto field = static_cast<BandField>(f);
+            const float value = params_.handle(i, Bank::A, field)->getValue();
+            mirrorValue(*params_.handle(i, Bank::B, field), value);
+        }
+    }
+}
+
+void LinkMirror::parameterValueChanged(int parameterIndex, float newValue) {
+    if (suspended_.load())
+        return;
+
+    if (parameterIndex == editTargetIndex_) {
+        // The APVTS copy of the value may not be updated yet when this runs, so decide from the new value itself.
+        const auto& editTarget = params_.getEditTargetParameter();
+        if (juce::roundToInt(editTarget.convertFrom0to1(newValue)) == static_cast<int>(EditTarget::Link))
+            copyBankAToB();
+        return;
+    }
+
+    if (parameterIndex < 0 || parameterIndex >= static_cast<int>(counterparts_.size()))
+        return;
+
+    auto* counterpart = counterparts_[static_cast<std::size_t>(parameterIndex)];
+    if (counterpart != nullptr && params_.getEditTarget() == EditTarget::Link)
+        mirrorValue(*counterpart, newValue);
+}
+
+void LinkMirror::parameterGestureChanged(int parameterIndex, bool gestureIsStarting) {
+    if (mirroringGesture_ || parameterIndex < 0 || parameterIndex >= static_cast<int>(counterparts_.size()))
+        return;
+
+    const auto index = static_cast<std::size_t>(parameterIndex);
+    auto* counterpart = counterparts_[index];
+    if (counterpart == nullptr)
+        return;
+
+    // Only gestures opened here are closed here, so switching Link mid-gesture cannot unbalance the counterpart.
+    const juce::ScopedValueSetter<bool> guard(mirroringGesture_, true);
+    if (gestureIsStarting && !mirroredGestures_[index] && !suspended_.load() &&
+        params_.getEditTarget() == EditTarget::Link) {
+        mirroredGestures_[index] = true;
+        counterpart->beginChangeGesture();
+    } else if (!gestureIsStarting && mirroredGestures_[index]) {
+        mirroredGestures_[index] = false;
+        counterpart->endChangeGesture();
+    }
+}
+
+} // namespace util
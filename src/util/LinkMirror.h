@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Params.h"
+#include <atomic>
+#include <vector>
+
+namespace util {
+
+// Keeps the two banks identical while the edit target is Link: a change to any band parameter of either bank is
+// copied to the same parameter of the other bank, and engaging Link copies bank A over bank B. It listens on the
+// parameter objects themselves, so it applies to host automation and to edits with the editor closed, and it never
+// builds or looks up an ID string. Mirrored writes of an equal value are skipped, which ends the A -> B -> A echo.
+// Change gestures are mirrored too, so a host sees the linked bank's edits grouped the same way.
+class LinkMirror final : private juce::AudioProcessorParameter::Listener {
+  public:
+    explicit LinkMirror(Params& params);
+    ~LinkMirror() override;
+
+    // Copies bank A over bank B if Link is active.
+    void synchronise();
+
+    // While suspended nothing is mirrored, e.g. while a saved state is being restored parameter by parameter.
+    void setSuspended(bool shouldBeSuspended) noexcept { suspended_.store(shouldBeSuspended); }
+
+  private:
+    Params& params_;
+    int editTargetIndex_ = -1;
+    // Indexed by parameter index: the same field of the same band in the other bank, or nullptr.
+    std::vector<juce::RangedAudioParameter*> counterparts_;
+    std::atomic<bool> suspended_{false};
+    // Gestures are UI-side, so these are only touched on the message thread. Indexed like counterparts_: whether a
+    // gesture was opened on that parameter's counterpart.
+    std::vector<bool> mirroredGestures_;
+    bool mirroringGesture_ = false;
+
+    void copyBankAToB();
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+};
+
+} // namespace util
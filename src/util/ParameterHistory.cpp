@@ -0,0 +1,155 @@
+#include "ParameterHistory.h"
+#include <algorithm>
+
+namespace util {
+
+ParameterHistory::ParameterHistory(juce::AudioProcessor& processor, std::size_t budgetBytes)
+    : budgetBytes_(budgetBytes) {
+    for (auto* parameter : processor.getParameters()) {
+        const auto index = static_cast<std::size_t>(parameter->getParameterIndex());
+        if (parameters_.size() <= index)
+            parameters_.resize(index + 1, nullptr);
+
+        parameters_[index] = parameter;
+        parameter->addListener(this);
+    }
+
+    jassert(parameters_.size() <= 0x10000);
+    gestureOpen_.resize(parameters_.size(), false);
+}
+
+ParameterHistory::~ParameterHistory() {
+    for (auto* parameter : parameters_) {
+        if (parameter != nullptr)
+            parameter->removeListener(this);
+    }
+}
+
+bool ParameterHistory::undo() {
+    if (undoSteps_.empty())
+        return false;
+
+    const auto size = undoSteps_.back();
+    undoSteps_.pop_back();
+
+    // Applied newest first; the step keeps its order on the redo side.
+    const auto first = undoChanges_.end() - static_cast<std::ptrdiff_t>(size);
+    for (auto change = undoChanges_.end(); change != first;)
+        apply(*--change, false);
+
+    redoChanges_.insert(redoChanges_.end(), first, undoChanges_.end());
+    redoSteps_.push_back(size);
+    undoChanges_.erase(first, undoChanges_.end());
+    return true;
+}
+
+bool ParameterHistory::redo() {
+    if (redoSteps_.empty())
+        return false;
+
+    const auto size = redoSteps_.back();
+    redoSteps_.pop_back();
+
+    const auto first = redoChanges_.end() - static_cast<std::ptrdiff_t>(size);
+    for (auto change = first; change != redoChanges_.end(); ++change)
+        apply(*change, true);
+
+    undoChanges_.insert(undoChanges_.end(), first, redoChanges_.end());
+    undoSteps_.push_back(size);
+    redoChanges_.erase(first, redoChanges_.end());
+    return true;
+}
+
+void ParameterHistory::clear() {
+    undoChanges_.clear();
+    undoSteps_.clear();
+    redoChanges_.clear();
+    redoSteps_.clear();
+    // A gesture still open keeps recording; its step will only hold values from after the clear.
+    for (auto& change : pending_)
+        change.before = parameters_[change.parameterIndex]->getValue();
+}
+
+std::size_t ParameterHistory::getMemoryFootprintBytes() const noexcept {
+    return sizeof(*this) + sizeof(parameters_[0]) * parameters_.capacity() +
+           sizeof(Change) * (undoChanges_.capacity() + redoChanges_.capacity() + pending_.capacity()) +
+           sizeof(std::uint32_t) * (undoSteps_.capacity() + redoSteps_.capacity()) + gestureOpen_.capacity() / 8;
+}
+
+void ParameterHistory::commitPending() {
+    for (auto& change : pending_)
+        change.after = parameters_[change.parameterIndex]->getValue();
+
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                  [](const Change& change) { return change.before == change.after; }),
+                   pending_.end());
+    if (pending_.empty())
+        return;
+
+    undoChanges_.insert(undoChanges_.end(), pending_.begin(), pending_.end());
+    undoSteps_.push_back(static_cast<std::uint32_t>(pending_.size()));
+    pending_.clear();
+
+    redoChanges_.clear();
+    redoSteps_.clear();
+    trimToBudget();
+}
+
+void ParameterHistory::trimToBudget() {
+    std::size_t numChanges = undoChanges_.size();
+    std::size_t firstKeptStep = 0;
+    auto usedBytes = [&] {
+        return sizeof(Change) * numChanges + sizeof(std::uint32_t) * (undoSteps_.size() - firstKeptStep);
+    };
+
+    // The newest step always stays, even if it alone is over budget.
+    while (undoSteps_.size() - firstKeptStep > 1 && usedBytes() > budgetBytes_)
+        numChanges -= undoSteps_[firstKeptStep++];
+
+    if (firstKeptStep == 0)
+        return;
+
+    const auto numDroppedChanges = static_cast<std::ptrdiff_t>(undoChanges_.size() - numChanges);
+    undoChanges_.erase(undoChanges_.begin(), undoChanges_.begin() + numDroppedChanges);
+    undoSteps_.erase(undoSteps_.begin(), undoSteps_.begin() + static_cast<std::ptrdiff_t>(firstKeptStep));
+    // Erasing keeps the capacity the appends grew, which would let the history hold up to twice its budget.
+    undoChanges_.shrink_to_fit();
+    undoSteps_.shrink_to_fit();
+}
+
+void ParameterHistory::apply(const Change& change, bool forward) {
+    auto* parameter = parameters_[change.parameterIndex];
+    const juce::ScopedValueSetter<bool> applying(applying_, true);
+    parameter->beginChangeGesture();
+    parameter->setValueNotifyingHost(forward ? change.after : change.before);
+    parameter->endChangeGesture();
+}
+
+// Values are read when gestures open and when the last one closes, so nothing happens per value; this also keeps
+// host automation, which may arrive on the audio thread, out of the history.
+void ParameterHistory::parameterValueChanged(int, float) {}
+
+void ParameterHistory::parameterGestureChanged(int parameterIndex, bool gestureIsStarting) {
+    if (applying_ || parameterIndex < 0 || parameterIndex >= static_cast<int>(parameters_.size()))
+        return;
+
+    const auto index = static_cast<std::size_t>(parameterIndex);
+    if (gestureIsStarting == gestureOpen_[index])
+        return;
+
+    gestureOpen_[index] = gestureIsStarting;
+    if (gestureIsStarting) {
+        ++numOpenGestures_;
+        const bool known = std::any_of(pending_.begin(), pending_.end(), [index](const Change& change) {
+            return change.parameterIndex == index;
+        });
+        if (!known)
+            pending_.push_back({static_cast<std::uint16_t>(index), parameters_[index]->getValue(), 0.0f});
+        return;
+    }
+
+    if (--numOpenGestures_ == 0)
+        commitPending();
+}
+
+} // namespace util
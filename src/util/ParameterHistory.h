@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <vector>
+
+namespace util {
+
+// Undo/redo for parameter edits, kept as a log of (parameter index, value before, value after) deltas rather than
+// state snapshots. Only edits made inside change gestures are recorded: every UI edit is one, host automation and
+// state loads are not. Overlapping gestures (a drag that moves frequency and gain, or Link mirroring a gesture to the
+// other bank) make one step, and each parameter appears in a step once however many values the drag went through.
+// The oldest steps are dropped to stay within the memory budget. Message thread only.
+class ParameterHistory final : private juce::AudioProcessorParameter::Listener {
+  public:
+    // About 5000 single-parameter steps.
+    static constexpr std::size_t DefaultBudgetBytes = 64 * 1024;
+
+    explicit ParameterHistory(juce::AudioProcessor& processor, std::size_t budgetBytes = DefaultBudgetBytes);
+    ~ParameterHistory() override;
+
+    [[nodiscard]] bool canUndo() const noexcept { return !undoSteps_.empty(); }
+    [[nodiscard]] bool canRedo() const noexcept { return !redoSteps_.empty(); }
+    [[nodiscard]] int getNumUndoSteps() const noexcept { return static_cast<int>(undoSteps_.size()); }
+
+    // Each applies one step as gestures of its own, so the host records it like any other edit.
+    bool undo();
+    bool redo();
+
+    // Forgets everything, e.g. after a state load has replaced the values the steps refer to.
+    void clear();
+
+    [[nodiscard]] std::size_t getMemoryFootprintBytes() const noexcept;
+
+  private:
+    // Normalised values.
+    struct Change {
+        std::uint16_t parameterIndex = 0;
+        float before = 0.0f;
+        float after = 0.0f;
+    };
+
+    std::vector<juce::AudioProcessorParameter*> parameters_;
+    std::size_t budgetBytes_;
+
+    // Steps are runs of changes; a step's size is its number of changes.
+    std::vector<Change> undoChanges_;
+    std::vector<std::uint32_t> undoSteps_;
+    std::vector<Change> redoChanges_;
+    std::vector<std::uint32_t> redoSteps_;
+
+    // The step being recorded while any gesture is open.
+    std::vector<Change> pending_;
+    std::vector<bool> gestureOpen_;
+    int numOpenGestures_ = 0;
+    bool applying_ = false;
+
+    void commitPending();
+    void trimToBudget();
+    void apply(const Change& change, bool forward);
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int parameterIndex, bool gestureIsStarting) override;
+};
+
+} // namespace util
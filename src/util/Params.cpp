@@ -1,37 +1,101 @@
 #include "Params.h"
+#include <string_view>
 
 namespace util {
 namespace {
 
-juce::String bandPrefixWithBank(int bandNum, Bank bank) {
-    const char bankChar = bank == Bank::A ? 'a' : 'b';
-    return "b" + juce::String(bandNum) + "_" + juce::String::charToString(bankChar) + "_";
+// Room for "b<NN>_<bank>_cut_slope" and the terminator.
+struct ParameterIdText {
+    std::array<char, 16> chars{};
+
+    [[nodiscard]] constexpr const char* c_str() const noexcept { return chars.data(); }
+};
+
+constexpr std::array<const char*, Params::NumBandFields> bandFieldSuffixes{
+    "enabled", "type", "freq", "gain", "q", "slope", "cut_slope", "cut_shape"};
+
+constexpr ParameterIdText makeBandId(int bandNum, Bank bank, BandField field) {
+    ParameterIdText id;
+    std::size_t length = 0;
+    auto append = [&id, &length](char c) { id.chars[length++] = c; };
+
+    append('b');
+    if (bandNum >= 10)
+        append(static_cast<char>('0' + bandNum / 10));
+    append(static_cast<char>('0' + bandNum % 10));
+    append('_');
+    append(bank == Bank::A ? 'a' : 'b');
+    append('_');
+    for (const char* c = bandFieldSuffixes[static_cast<std::size_t>(field)]; *c != '\0'; ++c)
+        append(*c);
+
+    return id;
 }
 
+using BandIdTable =
+    std::array<std::array<std::array<ParameterIdText, Params::NumBandFields>, 2>, Params::MaxBands>;
+
+constexpr BandIdTable makeBandIdTable() {
+    static_assert(Params::MaxBands < 100, "Band IDs have room for two digits");
+
+    BandIdTable table{};
+    for (int band = 0; band < Params::MaxBands; ++band) {
+        for (int bank = 0; bank < 2; ++bank) {
+            for (int field = 0; field < Params::NumBandFields; ++field) {
+                table[static_cast<std::size_t>(band)][static_cast<std::size_t>(bank)][static_cast<std::size_t>(
+                    field)] = makeBandId(band + 1, bank == 0 ? Bank::A : Bank::B, static_cast<BandField>(field));
+            }
+        }
+    }
+
+    return table;
+}
+
+constexpr BandIdTable bandIds = makeBandIdTable();
+
+static_assert(std::string_view(bandIds[0][0][2].c_str()) == "b1_a_freq");
+static_assert(std::string_view(bandIds[0][1][0].c_str()) == "b1_b_enabled");
+static_assert(std::string_view(bandIds[11][1][5].c_str()) == "b12_b_slope");
+static_assert(std::string_view(bandIds[31][1][7].c_str()) == "b32_b_cut_shape");
+
 } // namespace
 
-juce::String Params::IDs::enabled(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "enabled";
+const char* Params::IDs::enabled(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Enabled, bank);
+}
+
+const char* Params::IDs::type(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Type, bank);
+}
+
+const char* Params::IDs::freq(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Frequency, bank);
+}
+
+const char* Params::IDs::gain(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Gain, bank);
 }
 
-juce::String Params::IDs::type(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "type";
+const char* Params::IDs::q(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Q, bank);
 }
 
-juce::String Params::IDs::freq(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "freq";
+const char* Params::IDs::slope(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::Slope, bank);
 }
 
-juce::String Params::IDs::gain(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "gain";
+const char* Params::IDs::cutSlope(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::CutSlope, bank);
 }
 
-juce::String Params::IDs::q(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "q";
+const char* Params::IDs::cutShape(int bandNum, Bank bank) noexcept {
+    return field(bandNum, BandField::CutShape, bank);
 }
 
-juce::String Params::IDs::slope(int bandNum, Bank bank) {
-    return bandPrefixWithBank(bandNum, bank) + "slope";
+const char* Params::IDs::field(int bandNum, BandField field, Bank bank) noexcept {
+    jassert(bandNum >= 1 && bandNum <= MaxBands);
+    return bandIds[static_cast<std::size_t>(bandNum - 1)][bank == Bank::A ? 0U : 1U][static_cast<std::size_t>(field)]
+        .c_str();
 }
 
 Params::Params(juce::AudioProcessor& processor) : apvts(processor, nullptr, "PARAMS", createLayout()) {
@@ -45,8 +109,8 @@ Params::Params(juce::AudioProcessor& processor) : apvts(processor, nullptr, "PAR
     jassert(hqMode_ != nullptr);
     jassert(outputGainDb_ != nullptr);
 
-    auto cacheBandPointers = [this](std::array<BandParams, NumBands>& destination, Bank bank) {
-        for (int i = 0; i < NumBands; ++i) {
+    auto cacheBandPointers = [this](std::array<BandParams, MaxBands>& destination, Bank bank) {
+        for (int i = 0; i < MaxBands; ++i) {
             const int bandNum = i + 1;
             const auto index = static_cast<std::size_t>(i);
             destination[index].enabled = apvts.getRawParameterValue(IDs::enabled(bandNum, bank));
@@ -55,6 +119,8 @@ Params::Params(juce::AudioProcessor& processor) : apvts(processor, nullptr, "PAR
             destination[index].gain = apvts.getRawParameterValue(IDs::gain(bandNum, bank));
             destination[index].q = apvts.getRawParameterValue(IDs::q(bandNum, bank));
             destination[index].slope = apvts.getRawParameterValue(IDs::slope(bandNum, bank));
+            destination[index].cutSlope = apvts.getRawParameterValue(IDs::cutSlope(bandNum, bank));
+            destination[index].cutShape = apvts.getRawParameterValue(IDs::cutShape(bandNum, bank));
 
             jassert(destination[index].enabled != nullptr);
             jassert(destination[index].type != nullptr);
@@ -62,11 +128,42 @@ Params::Params(juce::AudioProcessor& processor) : apvts(processor, nullptr, "PAR
             jassert(destination[index].gain != nullptr);
             jassert(destination[index].q != nullptr);
             jassert(destination[index].slope != nullptr);
+            jassert(destination[index].cutSlope != nullptr);
+            jassert(destination[index].cutShape != nullptr);
         }
     };
 
     cacheBandPointers(bandsA_, Bank::A);
     cacheBandPointers(bandsB_, Bank::B);
+
+    editTargetParameter_ = apvts.getParameter(IDs::editTarget);
+    jassert(editTargetParameter_ != nullptr);
+
+    auto cacheBandParameters = [this](std::array<BandParameters, MaxBands>& destination, Bank bank) {
+        for (int i = 0; i < MaxBands; ++i) {
+            for (int f = 0; f < NumBandFields; ++f) {
+                auto* parameter = apvts.getParameter(IDs::field(i + 1, static_cast<BandField>(f), bank));
+                jassert(parameter != nullptr);
+                destination[static_cast<std::size_t>(i)][static_cast<std::size_t>(f)] = parameter;
+            }
+        }
+    };
+
+    cacheBandParameters(bandParametersA_, Bank::A);
+    cacheBandParameters(bandParametersB_, Bank::B);
+}
+
+FilterType Params::BandParams::getFilterType() const noexcept {
+    const auto baseType = static_cast<FilterType>(static_cast<int>(type->load(std::memory_order_relaxed)));
+    const auto shape = static_cast<CutShape>(static_cast<int>(cutShape->load(std::memory_order_relaxed)));
+    if (!isCutFilter(baseType) || shape != CutShape::LinkwitzRiley)
+        return baseType;
+
+    return baseType == FilterType::HighPass ? FilterType::HighPassLR : FilterType::LowPassLR;
+}
+
+Slope Params::BandParams::getSlope() const noexcept {
+    return static_cast<Slope>(static_cast<int>(cutSlope->load(std::memory_order_relaxed)));
 }
 
 float Params::getOutputGainDb() const noexcept {
@@ -90,15 +187,31 @@ EditTarget Params::getEditTarget() const noexcept {
 }
 
 const Params::BandParams& Params::getBand(int index, Bank bank) const noexcept {
-    jassert(index >= 0 && index < NumBands);
+    jassert(index >= 0 && index < MaxBands);
     return (bank == Bank::A ? bandsA_ : bandsB_)[static_cast<std::size_t>(index)];
 }
 
+int Params::getUsedBandCount() const noexcept {
+    for (int i = MaxBands - 1; i >= DefaultBandCount; --i) {
+        if (bandsA_[static_cast<std::size_t>(i)].enabled->load(std::memory_order_relaxed) > 0.5f ||
+            bandsB_[static_cast<std::size_t>(i)].enabled->load(std::memory_order_relaxed) > 0.5f)
+            return i + 1;
+    }
+
+    return DefaultBandCount;
+}
+
+juce::RangedAudioParameter* Params::handle(int index, Bank bank, BandField field) const noexcept {
+    jassert(index >= 0 && index < MaxBands);
+    const auto& parameters = (bank == Bank::A ? bandParametersA_ : bandParametersB_)[static_cast<std::size_t>(index)];
+    return parameters[static_cast<std::size_t>(field)];
+}
+
 int Params::defaultTypeIndexForBand(int bandNum) noexcept {
     if (bandNum == 1)
         return static_cast<int>(FilterType::HighPass);
 
-    if (bandNum == NumBands)
+    if (bandNum == DefaultBandCount)
         return static_cast<int>(FilterType::LowPass);
 
     return static_cast<int>(FilterType::Peak);
@@ -127,6 +240,35 @@ float Params::defaultFrequencyHzForBand(int bandNum) noexcept {
     }
 }
 
+juce::StringArray Params::getFilterTypeNames() {
+    return {"Peak", "Low Shelf", "High Shelf", "High Pass", "Low Pass"};
+}
+
+juce::StringArray Params::getSlopeNames() {
+    juce::StringArray names;
+    for (int order = 1; order <= getFilterOrder(Slope::Slope96dB); ++order)
+        names.add(juce::String(order * 6) + " dB/oct");
+    return names;
+}
+
+juce::StringArray Params::getLegacySlopeNames() {
+    return {"12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct"};
+}
+
+juce::StringArray Params::getCutShapeNames() {
+    return {"Butterworth", "Linkwitz-Riley"};
+}
+
+void Params::upgradeLegacySlope(FilterType type, float legacySlopeIndex, float& slopeIndex, float& q) noexcept {
+    // Legacy index k was a cascade of k + 1 biquads, i.e. order 2k + 2.
+    const int legacyIndex = juce::jlimit(0, 3, juce::roundToInt(legacySlopeIndex));
+    slopeIndex = static_cast<float>(slopeIndexForLegacySlope(legacyIndex));
+
+    // The new 12 dB cut runs its biquad at Q = 1 / sqrt(2) * (q / defaultQ()).
+    if (isCutFilter(type) && legacyIndex == 0)
+        q = juce::jlimit(0.1f, 18.0f, q * defaultQ() * juce::MathConstants<float>::sqrt2);
+}
+
 juce::AudioProcessorValueTreeState::ParameterLayout Params::createLayout() {
     std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
 
@@ -147,10 +289,10 @@ juce::AudioProcessorValueTreeState::ParameterLayout Params::createLayout() {
                                                                  juce::NormalisableRange<float>(-24.0f, 24.0f, 0.01f),
                                                                  0.0f));
 
-    // Filter type choices
-    juce::StringArray typeChoices{"Peak", "Low Shelf", "High Shelf", "High Pass", "Low Pass"};
-    // Slope choices
-    juce::StringArray slopeChoices{"12 dB/oct", "24 dB/oct", "36 dB/oct", "48 dB/oct"};
+    const auto typeChoices = getFilterTypeNames();
+    const auto slopeChoices = getSlopeNames();
+    const auto legacySlopeChoices = getLegacySlopeNames();
+    const auto cutShapeChoices = getCutShapeNames();
 
     auto addBandParametersForBank = [&](int bandNum, Bank bank) {
         const juce::String bankLabel = bank == Bank::A ? "A" : "B";
@@ -159,32 +301,44 @@ juce::AudioProcessorValueTreeState::ParameterLayout Params::createLayout() {
         const bool defaultEnabled = false;
         const int defaultType = defaultTypeIndexForBand(bandNum);
         const float defaultFreq = defaultFrequencyHzForBand(bandNum);
+        // AU hosts only pick up parameters added after a release if they carry a higher version hint.
+        const int versionHint = bandNum > DefaultBandCount ? 2 : 1;
+        auto parameterId = [versionHint](const char* id) { return juce::ParameterID(id, versionHint); };
 
-        params.push_back(std::make_unique<juce::AudioParameterBool>(juce::ParameterID(IDs::enabled(bandNum, bank), 1),
+        params.push_back(std::make_unique<juce::AudioParameterBool>(parameterId(IDs::enabled(bandNum, bank)),
                                                                     prefix + "Enabled", defaultEnabled));
 
-        params.push_back(std::make_unique<juce::AudioParameterChoice>(juce::ParameterID(IDs::type(bandNum, bank), 1),
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(parameterId(IDs::type(bandNum, bank)),
                                                                       prefix + "Type", typeChoices, defaultType));
 
         juce::NormalisableRange<float> freqRange(20.0f, 20000.0f, 0.1f);
         freqRange.setSkewForCentre(1000.0f);
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::freq(bandNum, bank), 1),
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(parameterId(IDs::freq(bandNum, bank)),
                                                                      prefix + "Freq", freqRange, defaultFreq));
 
         params.push_back(std::make_unique<juce::AudioParameterFloat>(
-            juce::ParameterID(IDs::gain(bandNum, bank), 1), prefix + "Gain",
+            parameterId(IDs::gain(bandNum, bank)), prefix + "Gain",
             juce::NormalisableRange<float>(-24.0f, 24.0f, 0.01f), defaultGainDb()));
 
         juce::NormalisableRange<float> qRange(0.1f, 18.0f, 0.01f);
         qRange.setSkewForCentre(1.0f);
-        params.push_back(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(IDs::q(bandNum, bank), 1),
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(parameterId(IDs::q(bandNum, bank)),
                                                                      prefix + "Q", qRange, defaultQ()));
 
         params.push_back(std::make_unique<juce::AudioParameterChoice>(
-            juce::ParameterID(IDs::slope(bandNum, bank), 1), prefix + "Slope", slopeChoices, defaultSlopeIndex()));
+            parameterId(IDs::slope(bandNum, bank)), prefix + "Slope", legacySlopeChoices, defaultLegacySlopeIndex()));
+
+        // Added with the 6-96 dB/oct cuts, after the type and slope above had shipped with fewer choices.
+        const juce::ParameterID cutSlopeId(IDs::cutSlope(bandNum, bank), 2);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(cutSlopeId, prefix + "Cut Slope", slopeChoices,
+                                                                      defaultSlopeIndex()));
+
+        const juce::ParameterID cutShapeId(IDs::cutShape(bandNum, bank), 2);
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(cutShapeId, prefix + "Cut Shape", cutShapeChoices,
+                                                                      defaultCutShapeIndex()));
     };
 
-    for (int i = 0; i < NumBands; ++i) {
+    for (int i = 0; i < MaxBands; ++i) {
         const int bandNum = i + 1;
         addBandParametersForBank(bandNum, Bank::A);
         addBandParametersForBank(bandNum, Bank::B);
@@ -6,9 +6,44 @@
 
 namespace util {
 
-enum class FilterType { Peak, LowShelf, HighShelf, HighPass, LowPass };
+// The LR types are Linkwitz-Riley cuts; the plain ones are Butterworth. The type parameter offers the first five, and a
+// band's cut shape turns its cuts into their LR variants (see BandParams::getFilterType()).
+enum class FilterType { Peak, LowShelf, HighShelf, HighPass, LowPass, HighPassLR, LowPassLR };
+
+enum class CutShape { Butterworth, LinkwitzRiley };
+
+// Cut slopes in 6 dB/oct steps, as the cut slope parameter offers them: the filter order is the index + 1.
+enum class Slope {
+    Slope6dB,
+    Slope12dB,
+    Slope18dB,
+    Slope24dB,
+    Slope30dB,
+    Slope36dB,
+    Slope42dB,
+    Slope48dB,
+    Slope54dB,
+    Slope60dB,
+    Slope66dB,
+    Slope72dB,
+    Slope78dB,
+    Slope84dB,
+    Slope90dB,
+    Slope96dB
+};
+
+[[nodiscard]] constexpr bool isCutFilter(FilterType type) noexcept {
+    return type == FilterType::HighPass || type == FilterType::LowPass || type == FilterType::HighPassLR ||
+           type == FilterType::LowPassLR;
+}
 
-enum class Slope { Slope12dB, Slope24dB, Slope36dB, Slope48dB };
+[[nodiscard]] constexpr bool isLinkwitzRiley(FilterType type) noexcept {
+    return type == FilterType::HighPassLR || type == FilterType::LowPassLR;
+}
+
+[[nodiscard]] constexpr int getFilterOrder(Slope slope) noexcept {
+    return static_cast<int>(slope) + 1;
+}
 
 enum class Bank { A, B };
 
@@ -18,9 +53,17 @@ enum class HQMode { Off, Oversampling2x };
 
 enum class EditTarget { Link, A, B };
 
+// Slope is the 12/24/36/48 dB/oct choice of the first release, kept so that hosts' automation of it still works (see
+// LegacySlopeForwarder); bands run at their CutSlope.
+enum class BandField { Enabled, Type, Frequency, Gain, Q, Slope, CutSlope, CutShape };
+
 class Params final {
   public:
-    static constexpr int NumBands = 8;
+    // Every band has parameters registered up front, since hosts need a fixed parameter list; a new instance uses the
+    // first DefaultBandCount and the rest stay disabled until added. Processing cost follows the enabled bands only.
+    static constexpr int MaxBands = 32;
+    static constexpr int DefaultBandCount = 8;
+    static constexpr int NumBandFields = 8;
 
     struct IDs {
         static constexpr const char* stereoMode = "stereo_mode";
@@ -28,12 +71,17 @@ class Params final {
         static constexpr const char* editTarget = "edit_target";
         static constexpr const char* outputGain = "out_gain";
 
-        static juce::String enabled(int bandNum, Bank bank = Bank::A);
-        static juce::String type(int bandNum, Bank bank = Bank::A);
-        static juce::String freq(int bandNum, Bank bank = Bank::A);
-        static juce::String gain(int bandNum, Bank bank = Bank::A);
-        static juce::String q(int bandNum, Bank bank = Bank::A);
-        static juce::String slope(int bandNum, Bank bank = Bank::A);
+        // Band IDs ("b<band>_<bank>_<field>") are looked up in a table generated at compile time: no string is
+        // built, and the returned pointers stay valid for the lifetime of the program.
+        static const char* enabled(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* type(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* freq(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* gain(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* q(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* slope(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* cutSlope(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* cutShape(int bandNum, Bank bank = Bank::A) noexcept;
+        static const char* field(int bandNum, BandField field, Bank bank = Bank::A) noexcept;
     };
 
     struct BandParams {
@@ -43,6 +91,12 @@ class Params final {
         std::atomic<float>* gain = nullptr;
         std::atomic<float>* q = nullptr;
         std::atomic<float>* slope = nullptr;
+        std::atomic<float>* cutSlope = nullptr;
+        std::atomic<float>* cutShape = nullptr;
+
+        // What the band runs: its type, a cut in the LR variant if that is its shape, and its cut slope.
+        [[nodiscard]] FilterType getFilterType() const noexcept;
+        [[nodiscard]] Slope getSlope() const noexcept;
     };
 
     explicit Params(juce::AudioProcessor& processor);
@@ -55,12 +109,39 @@ class Params final {
     bool isHQEnabled() const noexcept;
     EditTarget getEditTarget() const noexcept;
     const BandParams& getBand(int index, Bank bank = Bank::A) const noexcept;
+    // DefaultBandCount, or more when a band past them is enabled in either bank: the bands the UI shows.
+    [[nodiscard]] int getUsedBandCount() const noexcept;
+
+    // O(1) access to the parameter object behind a band field (band index is 0-based), for writing values and
+    // gestures without an ID lookup. Never null for valid arguments.
+    [[nodiscard]] juce::RangedAudioParameter* handle(int index, Bank bank, BandField field) const noexcept;
+    juce::RangedAudioParameter& getEditTargetParameter() const noexcept { return *editTargetParameter_; }
 
     static int defaultTypeIndexForBand(int bandNum) noexcept;
     static float defaultFrequencyHzForBand(int bandNum) noexcept;
     static constexpr float defaultGainDb() noexcept { return 0.0f; }
     static constexpr float defaultQ() noexcept { return 1.0f; }
-    static constexpr int defaultSlopeIndex() noexcept { return 0; }
+    static constexpr int defaultSlopeIndex() noexcept { return static_cast<int>(Slope::Slope12dB); }
+    static constexpr int defaultLegacySlopeIndex() noexcept { return 0; }
+    static constexpr int defaultCutShapeIndex() noexcept { return static_cast<int>(CutShape::Butterworth); }
+
+    // Choice names, in enum order. The type parameter has the first five filter types; the legacy slope parameter
+    // has 12/24/36/48 dB/oct.
+    static juce::StringArray getFilterTypeNames();
+    static juce::StringArray getSlopeNames();
+    static juce::StringArray getLegacySlopeNames();
+    static juce::StringArray getCutShapeNames();
+
+    // A legacy slope index k as a cut slope index: 12 (k + 1) dB/oct.
+    [[nodiscard]] static constexpr int slopeIndexForLegacySlope(int legacyIndex) noexcept {
+        return 2 * legacyIndex + 1;
+    }
+
+    // States saved before version 2 of the formats built a cut by cascading one RBJ biquad per legacy slope step at
+    // the band's Q. Gives such a band the cut slope its legacy slope stands for; a 12 dB cut also gets the Q under
+    // which the Butterworth design gives the same filter. Steeper legacy cuts keep their Q, since the cascade they
+    // were built from had a sagging corner that the new design deliberately does not reproduce.
+    static void upgradeLegacySlope(FilterType type, float legacySlopeIndex, float& slopeIndex, float& q) noexcept;
 
     static juce::AudioProcessorValueTreeState::ParameterLayout createLayout();
 
@@ -69,7 +150,12 @@ class Params final {
     std::atomic<float>* stereoMode_ = nullptr;
     std::atomic<float>* hqMode_ = nullptr;
     std::atomic<float>* outputGainDb_ = nullptr;
-    std::array<BandParams, NumBands> bandsA_;
-    std::array<BandParams, NumBands> bandsB_;
+    std::array<BandParams, MaxBands> bandsA_;
+    std::array<BandParams, MaxBands> bandsB_;
+
+    using BandParameters = std::array<juce::RangedAudioParameter*, NumBandFields>;
+    juce::RangedAudioParameter* editTargetParameter_ = nullptr;
+    std::array<BandParameters, MaxBands> bandParametersA_{};
+    std::array<BandParameters, MaxBands> bandParametersB_{};
 };
 } // namespace util
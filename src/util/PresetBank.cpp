@@ -0,0 +1,232 @@
+#include "PresetBank.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+namespace util {
+namespace {
+
+constexpr std::size_t HeaderBytes = 16;
+constexpr std::size_t RecordHeaderBytes = PresetBank::NameBytes + PresetBank::TagBytes + 4;
+
+void writeUInt(std::uint8_t* destination, std::uint32_t value, int numBytes) noexcept {
+    for (int i = 0; i < numBytes; ++i)
+        destination[i] = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+std::uint32_t readUInt(const std::uint8_t* source, int numBytes) noexcept {
+    std::uint32_t value = 0;
+    for (int i = 0; i < numBytes; ++i)
+        value |= static_cast<std::uint32_t>(source[i]) << (8 * i);
+    return value;
+}
+
+// Copies as much of `text` as fits in `fieldBytes` with room for a terminator, without splitting a UTF-8 sequence.
+void writeTextField(std::uint8_t* destination, const juce::String& text, int fieldBytes) noexcept {
+    const char* utf8 = text.toRawUTF8();
+    std::size_t length = std::min(std::strlen(utf8), static_cast<std::size_t>(fieldBytes - 1));
+    if (length < std::strlen(utf8)) {
+        while (length > 0 && (static_cast<unsigned char>(utf8[length]) & 0xc0) == 0x80)
+            --length;
+    }
+    std::memcpy(destination, utf8, length);
+}
+
+juce::String readTextField(const std::uint8_t* source, int fieldBytes) {
+    const auto* text = reinterpret_cast<const char*>(source);
+    const auto* end = static_cast<const char*>(std::memchr(text, 0, static_cast<std::size_t>(fieldBytes)));
+    return juce::String::fromUTF8(text, end != nullptr ? static_cast<int>(end - text) : fieldBytes);
+}
+
+juce::StringArray splitTags(const juce::String& text) {
+    juce::StringArray tags;
+    tags.addTokens(text, ",", "");
+    tags.trim();
+    tags.removeEmptyStrings();
+    return tags;
+}
+
+} // namespace
+
+bool PresetBank::write(const juce::File& file, const std::vector<Entry>& entries) {
+    std::size_t largestState = 0;
+    for (const auto& entry : entries)
+        largestState = std::max(largestState, entry.state.getSize());
+
+    // Records are kept 16-byte aligned so a state never straddles more cache lines than it must.
+    const std::size_t recordSize = (RecordHeaderBytes + largestState + 15) & ~static_cast<std::size_t>(15);
+    juce::MemoryBlock data;
+    data.setSize(HeaderBytes + recordSize * entries.size(), true);
+
+    auto* bytes = static_cast<std::uint8_t*>(data.getData());
+    writeUInt(bytes, Magic, 4);
+    writeUInt(bytes + 4, static_cast<std::uint32_t>(Version), 2);
+    writeUInt(bytes + 8, static_cast<std::uint32_t>(entries.size()), 4);
+    writeUInt(bytes + 12, static_cast<std::uint32_t>(recordSize), 4);
+
+    auto* record = bytes + HeaderBytes;
+    for (const auto& entry : entries) {
+        writeTextField(record, entry.name, NameBytes);
+        writeTextField(record + NameBytes, entry.tags.joinIntoString(","), TagBytes);
+        writeUInt(record + NameBytes + TagBytes, static_cast<std::uint32_t>(entry.state.getSize()), 4);
+        std::memcpy(record + RecordHeaderBytes, entry.state.getData(), entry.state.getSize());
+        record += recordSize;
+    }
+
+    return file.replaceWithData(data.getData(), data.getSize());
+}
+
+bool PresetBank::open(const juce::File& file) {
+    close();
+    if (!file.existsAsFile())
+        return false;
+
+    auto mapping = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+    const auto* bytes = static_cast<const std::uint8_t*>(mapping->getData());
+    const std::size_t size = mapping->getSize();
+    if (bytes == nullptr || size < HeaderBytes || readUInt(bytes, 4) != Magic)
+        return false;
+
+    const auto version = static_cast<int>(readUInt(bytes + 4, 2));
+    const std::size_t numRecords = readUInt(bytes + 8, 4);
+    const std::size_t recordSize = readUInt(bytes + 12, 4);
+    if (version < 1 || version > Version || recordSize <= RecordHeaderBytes ||
+        numRecords > static_cast<std::size_t>(std::numeric_limits<int>::max()) ||
+        numRecords > (size - HeaderBytes) / recordSize)
+        return false;
+
+    mapping_ = std::move(mapping);
+    records_ = bytes + HeaderBytes;
+    numRecords_ = static_cast<int>(numRecords);
+    recordSize_ = recordSize;
+    buildIndex();
+    return true;
+}
+
+void PresetBank::close() {
+    records_ = nullptr;
+    numRecords_ = 0;
+    recordSize_ = 0;
+    // Swapped out rather than cleared so a closed bank gives its index memory back.
+    std::vector<int>().swap(nameOrder_);
+    std::vector<juce::String>().swap(sortedNames_);
+    tagIndex_.clear();
+    mapping_.reset();
+}
+
+juce::String PresetBank::getName(int index) const {
+    const auto* record = getRecord(index);
+    return record != nullptr ? readTextField(record, NameBytes) : juce::String();
+}
+
+juce::StringArray PresetBank::getTags(int index) const {
+    const auto* record = getRecord(index);
+    return record != nullptr ? splitTags(readTextField(record + NameBytes, TagBytes)) : juce::StringArray();
+}
+
+PresetBank::State PresetBank::getState(int index) const noexcept {
+    const auto* record = getRecord(index);
+    if (record == nullptr)
+        return {};
+
+    const std::size_t stateSize = readUInt(record + NameBytes + TagBytes, 4);
+    if (stateSize == 0 || stateSize > recordSize_ - RecordHeaderBytes)
+        return {};
+
+    return {record + RecordHeaderBytes, static_cast<int>(stateSize)};
+}
+
+int PresetBank::findByName(const juce::String& name) const {
+    const auto key = name.toLowerCase();
+    const auto found = std::lower_bound(sortedNames_.begin(), sortedNames_.end(), key);
+    if (found == sortedNames_.end() || *found != key)
+        return -1;
+
+    return nameOrder_[static_cast<std::size_t>(found - sortedNames_.begin())];
+}
+
+const std::vector<int>& PresetBank::getPresetsWithTag(const juce::String& tag) const {
+    static const std::vector<int> none;
+    const auto found = tagIndex_.find(tag.toLowerCase());
+    return found != tagIndex_.end() ? found->second : none;
+}
+
+std::vector<int> PresetBank::search(const juce::String& query) const {
+    juce::StringArray words;
+    words.addTokens(query.toLowerCase(), " ", "");
+    words.removeEmptyStrings();
+
+    std::vector<int> matches;
+    for (std::size_t i = 0; i < nameOrder_.size(); ++i) {
+        const int index = nameOrder_[i];
+        const auto tags = words.isEmpty() ? juce::StringArray() : getTags(index);
+        const bool matchesAll = std::all_of(words.begin(), words.end(), [&](const juce::String& word) {
+            return sortedNames_[i].contains(word) ||
+                   std::any_of(tags.begin(), tags.end(),
+                               [&word](const juce::String& tag) { return tag.toLowerCase().startsWith(word); });
+        });
+        if (matchesAll)
+            matches.push_back(index);
+    }
+
+    return matches;
+}
+
+std::size_t PresetBank::getMemoryFootprintBytes() const noexcept {
+    // juce::String keeps a small header ahead of its UTF-8 text; map nodes carry three pointers and a colour.
+    constexpr std::size_t StringHeaderBytes = 2 * sizeof(void*);
+    constexpr std::size_t MapNodeBytes = 4 * sizeof(void*);
+    const auto stringBytes = [](const juce::String& text) {
+        return text.isEmpty() ? std::size_t{0} : StringHeaderBytes + text.getNumBytesAsUTF8() + 1;
+    };
+
+    std::size_t bytes = sizeof(*this) + nameOrder_.capacity() * sizeof(int) +
+                        sortedNames_.capacity() * sizeof(juce::String);
+    for (const auto& name : sortedNames_)
+        bytes += stringBytes(name);
+
+    for (const auto& [tag, indices] : tagIndex_)
+        bytes += MapNodeBytes + sizeof(*tagIndex_.begin()) + stringBytes(tag) + indices.capacity() * sizeof(int);
+
+    if (mapping_ != nullptr)
+        bytes += sizeof(juce::MemoryMappedFile);
+
+    return bytes;
+}
+
+const std::uint8_t* PresetBank::getRecord(int index) const noexcept {
+    if (index < 0 || index >= numRecords_)
+        return nullptr;
+
+    return records_ + static_cast<std::size_t>(index) * recordSize_;
+}
+
+void PresetBank::buildIndex() {
+    std::vector<juce::String> names;
+    names.reserve(static_cast<std::size_t>(numRecords_));
+    for (int i = 0; i < numRecords_; ++i) {
+        names.push_back(getName(i).toLowerCase());
+        for (const auto& tag : getTags(i))
+            tagIndex_[tag.toLowerCase()].push_back(i);
+    }
+
+    nameOrder_.resize(names.size());
+    std::iota(nameOrder_.begin(), nameOrder_.end(), 0);
+    std::stable_sort(nameOrder_.begin(), nameOrder_.end(), [&names](int a, int b) {
+        return names[static_cast<std::size_t>(a)] < names[static_cast<std::size_t>(b)];
+    });
+
+    sortedNames_.reserve(names.size());
+    for (const int index : nameOrder_)
+        sortedNames_.push_back(names[static_cast<std::size_t>(index)]);
+
+    for (auto& entry : tagIndex_) {
+        auto& indices = entry.second;
+        std::stable_sort(indices.begin(), indices.end(), [&names](int a, int b) {
+            return names[static_cast<std::size_t>(a)] < names[static_cast<std::size_t>(b)];
+        });
+    }
+}
+
+} // namespace util
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <juce_core/juce_core.h>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace util {
+
+// A read-only library of EQ states in one file of fixed-size records. The file is memory-mapped, so opening a bank
+// costs a header check plus a name and tag index, and fetching a preset's state is pointer arithmetic: no parsing,
+// whatever the size of the bank.
+//
+// Layout (little-endian): magic, uint16 version, uint16 reserved, uint32 record count, uint32 record size, then the
+// records. A record holds a NUL-padded UTF-8 name (NameBytes), NUL-padded comma-separated tags (TagBytes), a uint32
+// state size and a StateSerializer chunk, zero-padded to the record size.
+class PresetBank final {
+  public:
+    static constexpr std::uint32_t Magic = 0x42505145; // "EQPB"
+    static constexpr int Version = 1;
+    static constexpr int NameBytes = 64;
+    static constexpr int TagBytes = 60;
+
+    struct Entry {
+        juce::String name;
+        juce::StringArray tags;
+        // A StateSerializer chunk.
+        juce::MemoryBlock state;
+    };
+
+    // Points into the mapping, so it stays valid until the bank is reopened or closed.
+    struct State {
+        const void* data = nullptr;
+        int size = 0;
+    };
+
+    // Names and tags longer than their fields are truncated. Returns false if the file could not be written.
+    static bool write(const juce::File& file, const std::vector<Entry>& entries);
+
+    // Replaces the current bank; returns false, leaving the bank empty, if the file is missing or malformed.
+    bool open(const juce::File& file);
+    void close();
+
+    [[nodiscard]] int size() const noexcept { return numRecords_; }
+    [[nodiscard]] juce::String getName(int index) const;
+    [[nodiscard]] juce::StringArray getTags(int index) const;
+    [[nodiscard]] State getState(int index) const noexcept;
+
+    // Case-insensitive exact match, or -1.
+    [[nodiscard]] int findByName(const juce::String& name) const;
+    // Case-insensitive; in name order.
+    [[nodiscard]] const std::vector<int>& getPresetsWithTag(const juce::String& tag) const;
+    // Presets for which every word of `query` appears in the name or starts one of the tags, in name order. An
+    // empty query matches everything.
+    [[nodiscard]] std::vector<int> search(const juce::String& query) const;
+
+    // Heap bytes of the name and tag index. The mapped records are file-backed pages and are not counted.
+    [[nodiscard]] std::size_t getMemoryFootprintBytes() const noexcept;
+
+  private:
+    std::unique_ptr<juce::MemoryMappedFile> mapping_;
+    const std::uint8_t* records_ = nullptr;
+    int numRecords_ = 0;
+    std::size_t recordSize_ = 0;
+    // Record indices sorted by lower-case name, with those names alongside for binary search.
+    std::vector<int> nameOrder_;
+    std::vector<juce::String> sortedNames_;
+    std::map<juce::String, std::vector<int>> tagIndex_;
+
+    [[nodiscard]] const std::uint8_t* getRecord(int index) const noexcept;
+    void buildIndex();
+};
+
+} // namespace util
@@ -0,0 +1,298 @@
+#include "StateSerializer.h"
+#include <cmath>
+#include <cstring>
+#include <map>
+
+namespace util {
+namespace {
+
+constexpr std::size_t HeaderBytes = 8;
+constexpr std::size_t ChecksumBytes = 4;
+constexpr std::size_t MaxChunkBands = 0xffff;
+// Enabled to slope, as chunks before version 3 hold them.
+constexpr std::size_t Version2NumBandFields = 6;
+
+// How juce::AudioProcessorValueTreeState stores each parameter in its tree.
+constexpr const char* ParamTreeType = "PARAM";
+constexpr const char* ParamIdProperty = "id";
+constexpr const char* ParamValueProperty = "value";
+
+std::size_t getChunkSize(std::size_t numGlobals, std::size_t numBands,
+                         std::size_t numBandFields = Params::NumBandFields) noexcept {
+    return HeaderBytes + sizeof(float) * (numGlobals + 2 * numBands * numBandFields) + ChecksumBytes;
+}
+
+std::uint32_t computeChecksum(const std::uint8_t* bytes, std::size_t size) noexcept {
+    std::uint32_t hash = 2166136261U;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+void writeUInt(std::uint8_t*& destination, std::uint32_t value, int numBytes) noexcept {
+    for (int i = 0; i < numBytes; ++i)
+        *destination++ = static_cast<std::uint8_t>(value >> (8 * i));
+}
+
+std::uint32_t readUInt(const std::uint8_t*& source, int numBytes) noexcept {
+    std::uint32_t value = 0;
+    for (int i = 0; i < numBytes; ++i)
+        value |= static_cast<std::uint32_t>(*source++) << (8 * i);
+    return value;
+}
+
+void writeFloat(std::uint8_t*& destination, float value) noexcept {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeUInt(destination, bits, 4);
+}
+
+float readFloat(const std::uint8_t*& source) noexcept {
+    const std::uint32_t bits = readUInt(source, 4);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+const std::atomic<float>& getFieldValue(const Params::BandParams& band, BandField field) noexcept {
+    switch (field) {
+    case BandField::Enabled:
+        return *band.enabled;
+    case BandField::Type:
+        return *band.type;
+    case BandField::Frequency:
+        return *band.freq;
+    case BandField::Gain:
+        return *band.gain;
+    case BandField::Q:
+        return *band.q;
+    case BandField::Slope:
+        return *band.slope;
+    case BandField::CutSlope:
+        return *band.cutSlope;
+    case BandField::CutShape:
+        break;
+    }
+
+    return *band.cutShape;
+}
+
+// Fills in the cut slope and shape of a band read from a chunk older than version 3.
+void upgradeBand(int version, std::array<float, Params::NumBandFields>& values) noexcept {
+    auto value = [&values](BandField field) -> float& { return values[static_cast<std::size_t>(field)]; };
+    const auto type = static_cast<FilterType>(juce::roundToInt(value(BandField::Type)));
+    value(BandField::CutShape) = static_cast<float>(Params::defaultCutShapeIndex());
+
+    if (version < 2) {
+        Params::upgradeLegacySlope(type, value(BandField::Slope), value(BandField::CutSlope), value(BandField::Q));
+        return;
+    }
+
+    // The slope field held 6-96 dB/oct; the legacy slope it now stands for only matters to automation.
+    value(BandField::CutSlope) = value(BandField::Slope);
+    value(BandField::Slope) = static_cast<float>(Params::defaultLegacySlopeIndex());
+    if (isLinkwitzRiley(type)) {
+        const auto cutType = type == FilterType::HighPassLR ? FilterType::HighPass : FilterType::LowPass;
+        value(BandField::Type) = static_cast<float>(cutType);
+        value(BandField::CutShape) = static_cast<float>(CutShape::LinkwitzRiley);
+    }
+}
+
+void applyValue(juce::RangedAudioParameter& parameter, float value) {
+    // The checksum catches damage in transit, not a chunk written with garbage in it.
+    const float normalisedValue = std::isfinite(value) ? parameter.convertTo0to1(value) : parameter.getDefaultValue();
+    if (parameter.getValue() != normalisedValue)
+        parameter.setValueNotifyingHost(normalisedValue);
+}
+
+} // namespace
+
+StateSerializer::StateSerializer(Params& params) : params_(params) {
+    const std::array<const char*, NumGlobalFields> globalIds{Params::IDs::outputGain, Params::IDs::stereoMode,
+                                                             Params::IDs::hqMode, Params::IDs::editTarget};
+    for (std::size_t i = 0; i < globalIds.size(); ++i) {
+        globalParameters_[i] = params_.apvts.getParameter(globalIds[i]);
+        jassert(globalParameters_[i] != nullptr);
+    }
+
+    for (int i = 0; i < Params::MaxBands; ++i) {
+        for (int f = 0; f < Params::NumBandFields; ++f) {
+            const auto* parameter = params_.handle(i, Bank::A, static_cast<BandField>(f));
+            bandDefaults_[static_cast<std::size_t>(i)][static_cast<std::size_t>(f)] =
+                parameter->convertFrom0to1(parameter->getDefaultValue());
+        }
+    }
+}
+
+bool StateSerializer::isAtDefaults(int index, Bank bank) const noexcept {
+    // Raw values against cached defaults: a few loads per band instead of normalising every field.
+    const auto& band = params_.getBand(index, bank);
+    const auto& defaults = bandDefaults_[static_cast<std::size_t>(index)];
+    for (int f = 0; f < Params::NumBandFields; ++f) {
+        const auto field = static_cast<BandField>(f);
+        if (getFieldValue(band, field).load(std::memory_order_relaxed) != defaults[static_cast<std::size_t>(f)])
+            return false;
+    }
+
+    return true;
+}
+
+int StateSerializer::getNumBandsToSave() const noexcept {
+    // Trailing bands still at their defaults load as defaults anyway, so a simple setup saves a small chunk.
+    for (int i = Params::MaxBands - 1; i >= Params::DefaultBandCount; --i) {
+        if (!isAtDefaults(i, Bank::A) || !isAtDefaults(i, Bank::B))
+            return i + 1;
+    }
+
+    return Params::DefaultBandCount;
+}
+
+void StateSerializer::save(juce::MemoryBlock& destination) const {
+    const int numBandsToSave = getNumBandsToSave();
+    const auto numBands = static_cast<std::size_t>(numBandsToSave);
+    const std::size_t size = getChunkSize(NumGlobalFields, numBands);
+    destination.setSize(size);
+
+    auto* const start = static_cast<std::uint8_t*>(destination.getData());
+    auto* bytes = start;
+    writeUInt(bytes, Magic, 4);
+    writeUInt(bytes, static_cast<std::uint32_t>(Version), 2);
+    writeUInt(bytes, static_cast<std::uint32_t>(numBands), 2);
+
+    for (const auto* parameter : globalParameters_)
+        writeFloat(bytes, parameter->convertFrom0to1(parameter->getValue()));
+
+    for (const auto bank : {Bank::A, Bank::B}) {
+        for (int i = 0; i < numBandsToSave; ++i) {
+            for (int f = 0; f < Params::NumBandFields; ++f) {
+                const auto* parameter = params_.handle(i, bank, static_cast<BandField>(f));
+                writeFloat(bytes, parameter->convertFrom0to1(parameter->getValue()));
+            }
+        }
+    }
+
+    writeUInt(bytes, computeChecksum(start, static_cast<std::size_t>(bytes - start)), 4);
+    jassert(static_cast<std::size_t>(bytes - start) == size);
+}
+
+bool StateSerializer::isBinaryState(const void* data, int sizeInBytes) noexcept {
+    if (data == nullptr || sizeInBytes < static_cast<int>(HeaderBytes))
+        return false;
+
+    const auto* bytes = static_cast<const std::uint8_t*>(data);
+    return readUInt(bytes, 4) == Magic;
+}
+
+bool StateSerializer::load(const void* data, int sizeInBytes) {
+    if (!isBinaryState(data, sizeInBytes))
+        return false;
+
+    const auto* const start = static_cast<const std::uint8_t*>(data);
+    const auto* bytes = start + 4;
+    const auto version = static_cast<int>(readUInt(bytes, 2));
+    const auto numBands = static_cast<std::size_t>(readUInt(bytes, 2));
+    const auto size = static_cast<std::size_t>(sizeInBytes);
+    const auto numBandFields = version < 3 ? Version2NumBandFields : static_cast<std::size_t>(Params::NumBandFields);
+
+    if (version < 1 || version > Version || numBands > MaxChunkBands ||
+        size != getChunkSize(NumGlobalFields, numBands, numBandFields))
+        return false;
+
+    const auto* checksumBytes = start + size - ChecksumBytes;
+    if (readUInt(checksumBytes, 4) != computeChecksum(start, size - ChecksumBytes))
+        return false;
+
+    for (auto* parameter : globalParameters_)
+        applyValue(*parameter, readFloat(bytes));
+
+    for (const auto bank : {Bank::A, Bank::B}) {
+        for (std::size_t i = 0; i < numBands; ++i) {
+            std::array<float, Params::NumBandFields> values{};
+            for (std::size_t f = 0; f < numBandFields; ++f)
+                values[f] = readFloat(bytes);
+
+            if (i >= static_cast<std::size_t>(Params::MaxBands))
+                continue;
+
+            if (version < 3)
+                upgradeBand(version, values);
+
+            for (int f = 0; f < Params::NumBandFields; ++f)
+                applyValue(*params_.handle(static_cast<int>(i), bank, static_cast<BandField>(f)),
+                           values[static_cast<std::size_t>(f)]);
+        }
+
+        for (int i = static_cast<int>(numBands); i < Params::MaxBands; ++i) {
+            if (isAtDefaults(i, bank))
+                continue;
+
+            for (int f = 0; f < Params::NumBandFields; ++f) {
+                auto& parameter = *params_.handle(i, bank, static_cast<BandField>(f));
+                if (parameter.getValue() != parameter.getDefaultValue())
+                    parameter.setValueNotifyingHost(parameter.getDefaultValue());
+            }
+        }
+    }
+
+    return true;
+}
+
+bool StateSerializer::loadLegacyXml(const void* data, int sizeInBytes) {
+    const auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+    if (xml == nullptr || !xml->hasTagName(params_.apvts.state.getType()))
+        return false;
+
+    auto tree = juce::ValueTree::fromXml(*xml);
+    std::map<juce::String, juce::ValueTree> storedParameters;
+    for (int c = 0; c < tree.getNumChildren(); ++c) {
+        const auto child = tree.getChild(c);
+        storedParameters.emplace(child.getProperty(ParamIdProperty).toString(), child);
+    }
+
+    for (const auto bank : {Bank::A, Bank::B}) {
+        for (int i = 0; i < Params::MaxBands; ++i) {
+            std::array<juce::ValueTree, Params::NumBandFields> fields;
+            std::array<bool, Params::NumBandFields> isStored{};
+            for (int f = 0; f < Params::NumBandFields; ++f) {
+                const auto& id = params_.handle(i, bank, static_cast<BandField>(f))->paramID;
+                auto& fieldTree = fields[static_cast<std::size_t>(f)];
+                const auto stored = storedParameters.find(id);
+                if (stored != storedParameters.end()) {
+                    fieldTree = stored->second;
+                    isStored[static_cast<std::size_t>(f)] = true;
+                    continue;
+                }
+
+                // replaceState() leaves parameters missing from the tree as they are, so the bands past those saved
+                // would keep whatever they held before the load.
+                fieldTree = juce::ValueTree(ParamTreeType);
+                fieldTree.setProperty(ParamIdProperty, id, nullptr);
+                fieldTree.setProperty(ParamValueProperty,
+                                      bandDefaults_[static_cast<std::size_t>(i)][static_cast<std::size_t>(f)], nullptr);
+                tree.appendChild(fieldTree, nullptr);
+            }
+
+            // Every XML state predates the cut slopes, but only the slopes it holds are legacy ones.
+            if (!isStored[static_cast<std::size_t>(BandField::Slope)] ||
+                isStored[static_cast<std::size_t>(BandField::CutSlope)])
+                continue;
+
+            auto getValue = [&fields](BandField field) -> float {
+                return fields[static_cast<std::size_t>(field)].getProperty(ParamValueProperty);
+            };
+            const auto type = static_cast<FilterType>(juce::roundToInt(getValue(BandField::Type)));
+            float slope = getValue(BandField::CutSlope);
+            float q = getValue(BandField::Q);
+            Params::upgradeLegacySlope(type, getValue(BandField::Slope), slope, q);
+            fields[static_cast<std::size_t>(BandField::CutSlope)].setProperty(ParamValueProperty, slope, nullptr);
+            fields[static_cast<std::size_t>(BandField::Q)].setProperty(ParamValueProperty, q, nullptr);
+        }
+    }
+
+    params_.apvts.replaceState(tree);
+    return true;
+}
+
+} // namespace util
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Params.h"
+#include <array>
+#include <cstdint>
+
+namespace util {
+
+// Saves the parameters as a compact binary chunk and restores them without going through XML or a ValueTree.
+//
+// Layout (little-endian): magic, uint16 version, uint16 band count, the global fields, then every band field of
+// bank A followed by bank B in BandField order, all as float32 in the parameter's own range (so a choice is stored
+// as its index), and finally an FNV-1a checksum of everything before it. Storing real values rather than normalised
+// ones keeps a chunk valid across range changes. The band count stops after the last band that differs from its
+// defaults (never below Params::DefaultBandCount); bands a chunk lacks are reset to defaults on load, which also lets
+// chunks from builds with fewer bands load. Versions 1 and 2 lack the cut slope and shape fields, which are filled in
+// on load: a version 1 band gets the cut slope its legacy slope stands for (see Params::upgradeLegacySlope), and a
+// version 2 band, which kept its cut slope in the slope field and its Linkwitz-Riley cuts as two extra types, has
+// them moved to where they now live.
+class StateSerializer final {
+  public:
+    static constexpr std::uint32_t Magic = 0x46495145; // "EQIF"
+    static constexpr int Version = 3;
+
+    explicit StateSerializer(Params& params);
+
+    void save(juce::MemoryBlock& destination) const;
+
+    // True if the data starts like a binary chunk; anything else is legacy XML state.
+    [[nodiscard]] static bool isBinaryState(const void* data, int sizeInBytes) noexcept;
+
+    // Applies the chunk in one pass, writing only the parameters whose value differs. Returns false, leaving every
+    // parameter untouched, if the chunk is truncated, corrupt or from a newer version.
+    [[nodiscard]] bool load(const void* data, int sizeInBytes);
+
+    // Loads the APVTS tree that sessions saved before the binary format hold as XML, in one replaceState(). Band
+    // fields the tree lacks (every band past the eight those sessions had) are reset to their defaults, as bands past
+    // a chunk are; the slopes it holds are upgraded like those of a version 1 chunk. Returns false, leaving every
+    // parameter untouched, if the data is not such a tree.
+    [[nodiscard]] bool loadLegacyXml(const void* data, int sizeInBytes);
+
+  private:
+    static constexpr int NumGlobalFields = 4;
+
+    Params& params_;
+    // Output gain, stereo mode, HQ mode and edit target, in chunk order.
+    std::array<juce::RangedAudioParameter*, NumGlobalFields> globalParameters_{};
+
+    // Every band's default values, in the parameters' own ranges; both banks share them.
+    std::array<std::array<float, Params::NumBandFields>, Params::MaxBands> bandDefaults_{};
+
+    [[nodiscard]] bool isAtDefaults(int index, Bank bank) const noexcept;
+    [[nodiscard]] int getNumBandsToSave() const noexcept;
+};
+
+} // namespace util
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace util {
+
+// Lock-free single-producer / single-consumer handoff of the most recent value. The writer fills
+// getWriteBuffer() and publish()es it; the reader calls acquire() and, when it returns true, reads
+// getReadBuffer(). Values published while the reader is busy replace each other, so the reader only ever
+// sees the latest one. Neither side blocks or allocates; any allocation happens inside T when the writer
+// resizes its own slot.
+template <typename T> class TripleBuffer {
+  public:
+    [[nodiscard]] T& getWriteBuffer() noexcept { return buffers_[writeIndex_]; }
+
+    void publish() noexcept {
+        const auto previous = shared_.exchange(static_cast<std::uint8_t>(writeIndex_ | FreshBit),
+                                               std::memory_order_acq_rel);
+        writeIndex_ = static_cast<std::uint8_t>(previous & IndexMask);
+    }
+
+    // Returns true when a newer value than the current read buffer was published.
+    [[nodiscard]] bool acquire() noexcept {
+        if ((shared_.load(std::memory_order_relaxed) & FreshBit) == 0)
+            return false;
+
+        const auto previous = shared_.exchange(static_cast<std::uint8_t>(readIndex_), std::memory_order_acq_rel);
+        readIndex_ = static_cast<std::uint8_t>(previous & IndexMask);
+        return true;
+    }
+
+    [[nodiscard]] const T& getReadBuffer() const noexcept { return buffers_[readIndex_]; }
+
+  private:
+    static constexpr std::uint8_t IndexMask = 0x3;
+    static constexpr std::uint8_t FreshBit = 0x4;
+
+    std::array<T, 3> buffers_{};
+    std::uint8_t writeIndex_ = 0;
+    std::atomic<std::uint8_t> shared_{1};
+    std::uint8_t readIndex_ = 2;
+};
+
+} // namespace util
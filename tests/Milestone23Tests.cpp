@@ -1,12 +1,58 @@
+#include "../src/dsp/CutFilterDesign.h"
 #include "../src/dsp/EqBand.h"
+#include "../src/dsp/EqEngine.h"
+#include "../src/dsp/MultiResolutionAnalyzer.h"
+#include "../src/dsp/OctaveSmoother.h"
+#include "../src/dsp/ResponseCurve.h"
+#include "../src/ui/AnalysisScheduler.h"
+#include "../src/ui/FramePacer.h"
+#include "../src/ui/ParameterGestureWriter.h"
+#include "../src/ui/PolylineSimplifier.h"
+#include "../src/util/AnalyzerFifo.h"
+#include "../src/util/LegacySlopeForwarder.h"
+#include "../src/util/LinkMirror.h"
+#include "../src/util/ParameterHistory.h"
 #include "../src/util/Params.h"
+#include "../src/util/PresetBank.h"
+#include "../src/util/StateSerializer.h"
+#include "../src/util/TripleBuffer.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <juce_dsp/juce_dsp.h>
+#include <limits>
+#include <memory>
+#include <new>
 #include <string>
+#include <vector>
+
+namespace {
+std::atomic<long> heapAllocationCount{0};
+} // namespace
+
+// Counts every global heap allocation so tests can assert that hot paths stay allocation-free.
+void* operator new(std::size_t size) {
+    heapAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
 
 namespace {
 class DummyProcessor final : public juce::AudioProcessor {
@@ -58,6 +104,8 @@ struct BandStorage {
     std::atomic<float> gain{0.0f};
     std::atomic<float> q{0.707f};
     std::atomic<float> slope{0.0f};
+    std::atomic<float> cutSlope{1.0f};
+    std::atomic<float> cutShape{0.0f};
 
     util::Params::BandParams asParams() noexcept {
         util::Params::BandParams params;
@@ -67,6 +115,8 @@ struct BandStorage {
         params.gain = &gain;
         params.q = &q;
         params.slope = &slope;
+        params.cutSlope = &cutSlope;
+        params.cutShape = &cutShape;
         return params;
     }
 };
@@ -93,6 +143,45 @@ void fillSine(juce::AudioBuffer<float>& buffer, double sampleRate, double freque
     }
 }
 
+// Evaluates every enabled band's biquads directly as complex polynomials in z^-1, independently of ResponseCurve's
+// shared trigonometric terms and stage merging. HQ and output gain are not modelled.
+float computeReferenceMagnitudeDb(const ::dsp::ResponseCurve::State& state, double frequencyHz) {
+    using ArrayCoefficients = juce::dsp::IIR::ArrayCoefficients<float>;
+    const double omega = juce::MathConstants<double>::twoPi * frequencyHz / state.sampleRate;
+    const std::complex<double> zInv = std::polar(1.0, -omega);
+    std::complex<double> response = 1.0;
+
+    for (const auto& band : state.bands) {
+        if (!band.enabled)
+            continue;
+
+        std::vector<std::array<float, 6>> sections;
+        if (util::isCutFilter(band.type)) {
+            const auto cascade = ::dsp::CutFilterDesign::design(band.type, band.slope, state.sampleRate,
+                                                                band.frequencyHz, band.q / util::Params::defaultQ());
+            sections.assign(cascade.sections.begin(), cascade.sections.begin() + cascade.numSections);
+        } else {
+            const float gain = juce::Decibels::decibelsToGain(band.gainDb);
+            if (band.type == util::FilterType::Peak)
+                sections.push_back(ArrayCoefficients::makePeakFilter(state.sampleRate, band.frequencyHz, band.q, gain));
+            else if (band.type == util::FilterType::LowShelf)
+                sections.push_back(ArrayCoefficients::makeLowShelf(state.sampleRate, band.frequencyHz, band.q, gain));
+            else
+                sections.push_back(ArrayCoefficients::makeHighShelf(state.sampleRate, band.frequencyHz, band.q, gain));
+        }
+
+        for (const auto& c : sections) {
+            const auto numerator = static_cast<double>(c[0]) + zInv * (static_cast<double>(c[1]) +
+                                                                         zInv * static_cast<double>(c[2]));
+            const auto denominator = static_cast<double>(c[3]) + zInv * (static_cast<double>(c[4]) +
+                                                                           zInv * static_cast<double>(c[5]));
+            response *= numerator / denominator;
+        }
+    }
+
+    return juce::jlimit(-48.0f, 24.0f, static_cast<float>(20.0 * std::log10(std::abs(response))));
+}
+
 float computeRms(const juce::AudioBuffer<float>& buffer, int channel) {
     const float* data = buffer.getReadPointer(channel);
     double sumSquares = 0.0;
@@ -136,7 +225,7 @@ bool testParamsIncludeMilestone2Ids() {
     ok &= expect(params.apvts.getParameter(util::Params::IDs::hqMode) != nullptr, "Missing hq_mode parameter");
     ok &= expect(params.apvts.getParameter(util::Params::IDs::outputGain) != nullptr, "Missing out_gain parameter");
 
-    for (int bandNum = 1; bandNum <= util::Params::NumBands; ++bandNum) {
+    for (int bandNum = 1; bandNum <= util::Params::MaxBands; ++bandNum) {
         for (const auto bank : {util::Bank::A, util::Bank::B}) {
             const auto bankLabel = bank == util::Bank::A ? "A" : "B";
             ok &= expect(params.apvts.getParameter(util::Params::IDs::enabled(bandNum, bank)) != nullptr,
@@ -151,6 +240,10 @@ bool testParamsIncludeMilestone2Ids() {
                          "Missing q parameter for band " + std::to_string(bandNum) + " bank " + bankLabel);
             ok &= expect(params.apvts.getParameter(util::Params::IDs::slope(bandNum, bank)) != nullptr,
                          "Missing slope parameter for band " + std::to_string(bandNum) + " bank " + bankLabel);
+            ok &= expect(params.apvts.getParameter(util::Params::IDs::cutSlope(bandNum, bank)) != nullptr,
+                         "Missing cut slope parameter for band " + std::to_string(bandNum) + " bank " + bankLabel);
+            ok &= expect(params.apvts.getParameter(util::Params::IDs::cutShape(bandNum, bank)) != nullptr,
+                         "Missing cut shape parameter for band " + std::to_string(bandNum) + " bank " + bankLabel);
         }
     }
 
@@ -171,9 +264,9 @@ bool testCutBandsDisabledByDefault() {
     util::Params params(processor);
 
     const auto& band1 = params.getBand(0);
-    const auto& band8 = params.getBand(util::Params::NumBands - 1);
+    const auto& band8 = params.getBand(util::Params::DefaultBandCount - 1);
     const auto& band1B = params.getBand(0, util::Bank::B);
-    const auto& band8B = params.getBand(util::Params::NumBands - 1, util::Bank::B);
+    const auto& band8B = params.getBand(util::Params::DefaultBandCount - 1, util::Bank::B);
 
     const bool band1Enabled = band1.enabled->load(std::memory_order_relaxed) > 0.5f;
     const bool band8Enabled = band8.enabled->load(std::memory_order_relaxed) > 0.5f;
@@ -242,7 +335,7 @@ bool testLowPassCutoffRespondsToFrequencyChanges() {
     BandStorage storage;
     storage.type.store(4.0f); // LowPass
     storage.q.store(0.707f);
-    storage.slope.store(0.0f);
+    storage.cutSlope.store(1.0f);
 
     auto params = storage.asParams();
     constexpr double testToneHz = 8000.0;
@@ -270,7 +363,7 @@ bool testPeakBandRespondsToGainChanges() {
     storage.type.store(0.0f); // Peak
     storage.freq.store(1000.0f);
     storage.q.store(1.2f);
-    storage.slope.store(0.0f);
+    storage.cutSlope.store(1.0f);
 
     auto params = storage.asParams();
     constexpr double testToneHz = 1000.0;
@@ -284,16 +377,1265 @@ bool testPeakBandRespondsToGainChanges() {
 
     return expect(boostedRms > unityRms * 1.5f, "Peak gain changes should audibly boost a tone near center frequency");
 }
+
+bool testEngineRecallSnapsAndCrossfades() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    ::dsp::EqEngine engine;
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = 48000.0;
+    spec.maximumBlockSize = 256;
+    spec.numChannels = 2;
+    engine.prepare(spec);
+
+    auto set = [&params](util::BandField field, float value) {
+        auto& parameter = *params.handle(4, util::Bank::A, field);
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+    };
+    set(util::BandField::Enabled, 1.0f);
+    set(util::BandField::Frequency, 1000.0f);
+    set(util::BandField::Q, 1.0f);
+    set(util::BandField::Gain, 12.0f);
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    double phase = 0.0;
+    float previousSample = 0.0f;
+    float largestStep = 0.0f;
+    auto processBlock = [&] {
+        fillSine(buffer, spec.sampleRate, 1000.0, phase);
+        engine.updateParameters(params, util::Bank::A, buffer.getNumSamples(), spec.sampleRate);
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        engine.process(context);
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i) {
+            largestStep = std::max(largestStep, std::abs(buffer.getSample(0, i) - previousSample));
+            previousSample = buffer.getSample(0, i);
+        }
+        return computeRms(buffer, 0);
+    };
+
+    for (int block = 0; block < 20; ++block)
+        processBlock();
+    const float steadyStep = largestStep;
+
+    set(util::BandField::Gain, -12.0f);
+    engine.prepareRecall(params, util::Bank::A, spec.sampleRate);
+    for (int block = 0; block < 5; ++block)
+        processBlock();
+    const float recalledRms = processBlock();
+
+    // Six blocks is 32 ms: past the 20 ms crossfade, but a 50 ms smoother sweep would still be near 0 dB.
+    const float expectedRms = juce::Decibels::decibelsToGain(-12.0f) * std::sqrt(0.5f);
+    bool ok = expect(std::abs(recalledRms - expectedRms) < expectedRms * 0.1f,
+                     "A recalled state should be fully in place once the crossfade ends");
+    ok &= expect(largestStep <= steadyStep * 1.05f, "Recalling a state should not produce a click");
+    return ok;
+}
+
+bool testBandsPastTheDefaultCountWorkAndCostNothingUnused() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::StateSerializer serializer(params);
+    ::dsp::EqEngine engine;
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = 48000.0;
+    spec.maximumBlockSize = 256;
+    spec.numChannels = 2;
+    engine.prepare(spec);
+    bool ok = true;
+
+    juce::MemoryBlock defaultState;
+    serializer.save(defaultState);
+    ok &= expect(params.getUsedBandCount() == util::Params::DefaultBandCount,
+                 "A new instance should use the default band count");
+    bool versionHintsMatch = true;
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
+        for (int f = 0; f < util::Params::NumBandFields; ++f) {
+            const bool firstRelease =
+                i < util::Params::DefaultBandCount && f <= static_cast<int>(util::BandField::Slope);
+            const auto* parameter = params.handle(i, util::Bank::B, static_cast<util::BandField>(f));
+            versionHintsMatch = versionHintsMatch && parameter->getVersionHint() == (firstRelease ? 1 : 2);
+        }
+    }
+    ok &= expect(versionHintsMatch, "Parameters added after the first release should carry version hint 2");
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    double phase = 0.0;
+    auto processBlock = [&] {
+        fillSine(buffer, spec.sampleRate, 1000.0, phase);
+        engine.updateParameters(params, util::Bank::A, buffer.getNumSamples(), spec.sampleRate);
+        juce::dsp::AudioBlock<float> block(buffer);
+        juce::dsp::ProcessContextReplacing<float> context(block);
+        engine.process(context);
+        return computeRms(buffer, 0);
+    };
+
+    processBlock();
+    ok &= expect(engine.getNumActiveBands() == 0, "With no band enabled no band should be processed");
+
+    constexpr int bandIndex = 19;
+    auto set = [&params](util::BandField field, float value) {
+        auto& parameter = *params.handle(bandIndex, util::Bank::A, field);
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+    };
+    set(util::BandField::Enabled, 1.0f);
+    set(util::BandField::Frequency, 1000.0f);
+    set(util::BandField::Gain, 12.0f);
+    ok &= expect(params.getUsedBandCount() == bandIndex + 1, "An enabled band should extend the bands in use");
+
+    // Automation may enable a band mid-render; it has to be heard from that block on, with nothing else running.
+    float rms = processBlock();
+    ok &= expect(rms > std::sqrt(0.5f) * 1.5f && engine.getNumActiveBands() == 1,
+                 "A band enabled past the default count should process from the block it was enabled in");
+    for (int block = 0; block < 20; ++block)
+        rms = processBlock();
+    ok &= expect(rms > std::sqrt(0.5f) * 3.0f, "A band past the default count should process audio");
+    ok &= expect(engine.getNumActiveBands() == 1, "Only the enabled band should be processed, whatever the pool size");
+
+    juce::MemoryBlock extendedState;
+    serializer.save(extendedState);
+    ok &= expect(defaultState.getSize() < extendedState.getSize(),
+                 "Unused trailing bands should be left out of a saved state");
+
+    DummyProcessor otherProcessor;
+    util::Params otherParams(otherProcessor);
+    util::StateSerializer otherSerializer(otherParams);
+    ok &= expect(otherSerializer.load(extendedState.getData(), static_cast<int>(extendedState.getSize())) &&
+                     std::abs(otherParams.getBand(bandIndex).gain->load() - 12.0f) < 0.01f &&
+                     otherParams.getUsedBandCount() == bandIndex + 1,
+                 "Bands past the default count should survive a save and load");
+    ok &= expect(otherSerializer.load(defaultState.getData(), static_cast<int>(defaultState.getSize())) &&
+                     otherParams.getUsedBandCount() == util::Params::DefaultBandCount &&
+                     std::abs(otherParams.getBand(bandIndex).gain->load()) < 0.01f,
+                 "Loading a state without those bands should reset them to defaults");
+    return ok;
+}
+
+bool testResponseCurveFrameLoopDoesNotAllocate() {
+    DummyProcessor processor;
+    util::Params params(processor);
+
+    auto setParameter = [&params](const juce::String& id, float value) {
+        auto* parameter = params.apvts.getParameter(id);
+        parameter->setValueNotifyingHost(parameter->convertTo0to1(value));
+    };
+
+    setParameter(util::Params::IDs::enabled(1), 1.0f);
+    setParameter(util::Params::IDs::cutSlope(1), 2.0f);
+    setParameter(util::Params::IDs::enabled(4), 1.0f);
+    setParameter(util::Params::IDs::gain(4), 9.0f);
+    setParameter(util::Params::IDs::enabled(7), 1.0f);
+    setParameter(util::Params::IDs::type(7), 2.0f); // HighShelf
+    setParameter(util::Params::IDs::gain(7), -6.0f);
+
+    constexpr double sampleRate = 48000.0;
+    constexpr std::size_t numPoints = 1200;
+    std::vector<double> frequencies(numPoints);
+    for (std::size_t i = 0; i < numPoints; ++i)
+        frequencies[i] = 20.0 * std::pow(1000.0, static_cast<double>(i) / static_cast<double>(numPoints - 1));
+
+    ::dsp::ResponseCurve::Workspace workspace;
+    workspace.setFrequencies(frequencies.data(), frequencies.size());
+    std::vector<float> magnitudeDb(numPoints);
+    std::vector<float> secondaryMagnitudeDb(numPoints);
+
+    const long allocationsBefore = heapAllocationCount.load();
+    for (int frame = 0; frame < 64; ++frame) {
+        const auto state = ::dsp::ResponseCurve::capture(params, sampleRate, util::Bank::A);
+        ::dsp::ResponseCurve::computeMagnitudeDb(state, workspace, magnitudeDb.data());
+
+        const auto secondaryState = ::dsp::ResponseCurve::capture(params, sampleRate, util::Bank::B);
+        ::dsp::ResponseCurve::computeMagnitudeDb(secondaryState, workspace, secondaryMagnitudeDb.data());
+    }
+    const long frameLoopAllocations = heapAllocationCount.load() - allocationsBefore;
+
+    const auto state = ::dsp::ResponseCurve::capture(params, sampleRate, util::Bank::A);
+    bool matchesReference = true;
+    for (std::size_t i = 0; matchesReference && i < numPoints; ++i)
+        matchesReference = std::abs(computeReferenceMagnitudeDb(state, frequencies[i]) - magnitudeDb[i]) < 1.0e-3f;
+
+    const auto allocationMessage =
+        "Response curve frame loop should not allocate (saw " + std::to_string(frameLoopAllocations) + ")";
+    return expect(frameLoopAllocations == 0, allocationMessage) &&
+           expect(matchesReference, "Buffer-writing response curve should match a direct complex evaluation");
+}
+
+bool testResponseCurveGroupDelayMatchesPhaseSlope() {
+    ::dsp::ResponseCurve::State state;
+    state.sampleRate = 48000.0;
+    state.bands[0].enabled = true;
+    state.bands[0].type = util::FilterType::HighPass;
+    state.bands[0].frequencyHz = 80.0f;
+    state.bands[0].slope = util::Slope::Slope24dB;
+    state.bands[3].enabled = true;
+    state.bands[3].frequencyHz = 2500.0f;
+    state.bands[3].gainDb = 8.0f;
+    state.bands[3].q = 2.0f;
+
+    constexpr double stepHz = 0.5;
+    const std::vector<double> frequencies{1000.0 - stepHz, 1000.0, 1000.0 + stepHz,
+                                          2500.0 - stepHz, 2500.0, 2500.0 + stepHz};
+
+    ::dsp::ResponseCurve::Workspace workspace;
+    workspace.setFrequencies(frequencies.data(), frequencies.size());
+    std::vector<float> magnitudeDb(frequencies.size());
+    std::vector<float> phaseRadians(frequencies.size());
+    std::vector<float> groupDelaySamples(frequencies.size());
+    std::vector<float> referenceMagnitudeDb(frequencies.size());
+
+    const auto design = ::dsp::ResponseCurve::design(state);
+    ::dsp::ResponseCurve::computeResponse(design, workspace, magnitudeDb.data(), phaseRadians.data(),
+                                          groupDelaySamples.data());
+    ::dsp::ResponseCurve::computeMagnitudeDb(design, workspace, referenceMagnitudeDb.data());
+
+    bool magnitudeMatches = true;
+    for (std::size_t i = 0; i < frequencies.size(); ++i)
+        magnitudeMatches = magnitudeMatches && std::abs(magnitudeDb[i] - referenceMagnitudeDb[i]) < 1.0e-3f;
+
+    // tau = -dphi/domega, with omega in radians per sample.
+    const double omegaStep = juce::MathConstants<double>::twoPi * 2.0 * stepHz / state.sampleRate;
+    bool delayMatchesSlope = true;
+    for (std::size_t centre : {std::size_t{1}, std::size_t{4}}) {
+        const double numericalDelay =
+            -static_cast<double>(phaseRadians[centre + 1] - phaseRadians[centre - 1]) / omegaStep;
+        delayMatchesSlope = delayMatchesSlope && std::abs(numericalDelay - groupDelaySamples[centre]) < 0.05;
+        delayMatchesSlope =
+            delayMatchesSlope &&
+            std::abs(::dsp::ResponseCurve::computeGroupDelaySamples(design, frequencies[centre]) -
+                     static_cast<double>(groupDelaySamples[centre])) < 1.0e-3;
+    }
+
+    std::vector<float> phaseOnlyRadians(frequencies.size());
+    ::dsp::ResponseCurve::computeResponse(design, workspace, nullptr, phaseOnlyRadians.data(), nullptr);
+    const bool phaseOnlyMatches = phaseOnlyRadians == phaseRadians;
+
+    auto hqState = state;
+    hqState.hqEnabled = true;
+    const auto hqDesign = ::dsp::ResponseCurve::design(hqState);
+    const double addedDelay = ::dsp::ResponseCurve::computeGroupDelaySamples(hqDesign, 1000.0) -
+                              ::dsp::ResponseCurve::computeGroupDelaySamples(design, 1000.0);
+
+    // Phase should cost well under twice magnitude on a plot-sized grid. The two are timed alternately and the best
+    // run of each kept, so scheduling noise and load from other processes hit both alike.
+    constexpr std::size_t numPoints = 1200;
+    std::vector<double> plotFrequencies(numPoints);
+    for (std::size_t i = 0; i < numPoints; ++i)
+        plotFrequencies[i] = 20.0 * std::pow(1000.0, static_cast<double>(i) / static_cast<double>(numPoints - 1));
+    workspace.setFrequencies(plotFrequencies.data(), numPoints);
+    std::vector<float> plotValues(numPoints);
+
+    auto timeMs = [](auto&& body) {
+        const double start = juce::Time::getMillisecondCounterHiRes();
+        for (int i = 0; i < 20; ++i)
+            body();
+        return juce::Time::getMillisecondCounterHiRes() - start;
+    };
+    double magnitudeMs = std::numeric_limits<double>::max();
+    double phaseMs = std::numeric_limits<double>::max();
+    for (int run = 0; run < 31; ++run) {
+        magnitudeMs = std::min(magnitudeMs, timeMs([&] {
+                                   ::dsp::ResponseCurve::computeMagnitudeDb(design, workspace, plotValues.data());
+                               }));
+        phaseMs = std::min(phaseMs, timeMs([&] {
+                               ::dsp::ResponseCurve::computeResponse(design, workspace, nullptr, plotValues.data(),
+                                                                     nullptr);
+                           }));
+    }
+
+    return expect(magnitudeMatches, "Response magnitude should match the magnitude-only evaluation") &&
+           expect(delayMatchesSlope, "Group delay should match the numerical slope of the phase response") &&
+           expect(phaseOnlyMatches, "Phase should not depend on whether group delay is requested") &&
+           expect(addedDelay > 0.5, "HQ oversampling filters should add group delay at 1 kHz") &&
+           expect(phaseMs < 2.0 * magnitudeMs, "Phase should cost well under twice the magnitude evaluation (" +
+                                                   std::to_string(phaseMs) + " vs " + std::to_string(magnitudeMs) +
+                                                   " ms)");
+}
+
+bool testAdaptiveResponseMatchesDenseEvaluation() {
+    constexpr double sampleRate = 48000.0;
+    constexpr std::size_t numPoints = 1400;
+    std::vector<double> frequencies(numPoints);
+    for (std::size_t i = 0; i < numPoints; ++i)
+        frequencies[i] = 20.0 * std::pow(1000.0, static_cast<double>(i) / static_cast<double>(numPoints - 1));
+
+    ::dsp::ResponseCurve::Workspace workspace;
+    workspace.setFrequencies(frequencies.data(), frequencies.size());
+    std::vector<float> denseDb(numPoints);
+    std::vector<float> adaptiveDb(numPoints);
+
+    ::dsp::ResponseCurve::State busy;
+    busy.sampleRate = sampleRate;
+    busy.bands[0] = {true, util::FilterType::HighPass, 35.0f, 0.0f, 0.71f, util::Slope::Slope48dB};
+    busy.bands[1] = {true, util::FilterType::LowShelf, 120.0f, 4.5f, 0.8f, util::Slope::Slope12dB};
+    busy.bands[2] = {true, util::FilterType::Peak, 440.0f, -18.0f, 18.0f, util::Slope::Slope12dB};
+    busy.bands[3] = {true, util::FilterType::Peak, 3150.0f, 12.0f, 9.0f, util::Slope::Slope12dB};
+    busy.bands[4] = {true, util::FilterType::Peak, 3300.0f, -6.0f, 0.3f, util::Slope::Slope12dB};
+    busy.bands[5] = {true, util::FilterType::HighShelf, 9000.0f, -3.0f, 0.7f, util::Slope::Slope12dB};
+    busy.bands[7] = {true, util::FilterType::LowPass, 18000.0f, 0.0f, 0.71f, util::Slope::Slope24dB};
+
+    auto hq = busy;
+    hq.hqEnabled = true;
+
+    ::dsp::ResponseCurve::State flat;
+    flat.sampleRate = sampleRate;
+
+    bool ok = true;
+    for (const auto* state : {&busy, &hq, &flat}) {
+        ::dsp::ResponseCurve::computeMagnitudeDb(*state, workspace, denseDb.data());
+        const auto evaluations = ::dsp::ResponseCurve::computeMagnitudeDbAdaptive(*state, workspace, adaptiveDb.data());
+
+        float maxErrorDb = 0.0f;
+        for (std::size_t i = 0; i < numPoints; ++i)
+            maxErrorDb = std::max(maxErrorDb, std::abs(denseDb[i] - adaptiveDb[i]));
+
+        ok &= expect(maxErrorDb <= 0.05f,
+                     "Adaptive response should stay within 0.05 dB (max error " + std::to_string(maxErrorDb) + ")");
+        ok &= expect(evaluations < numPoints / 2, "Adaptive response should evaluate fewer than half the points (" +
+                                                      std::to_string(evaluations) + ")");
+    }
+
+    return ok;
+}
+
+bool testCutSlopesFollowTheirFilterFamily() {
+    const std::vector<double> frequencies{500.0, 1000.0, 2000.0};
+    bool ok = true;
+
+    auto measure = [&frequencies](util::FilterType type, int slopeIndex) {
+        ::dsp::ResponseCurve::State state;
+        state.sampleRate = 48000.0;
+        state.bands[0].enabled = true;
+        state.bands[0].type = type;
+        state.bands[0].frequencyHz = 1000.0f;
+        state.bands[0].q = util::Params::defaultQ();
+        state.bands[0].slope = static_cast<util::Slope>(slopeIndex);
+        return ::dsp::ResponseCurve::computeMagnitudeDb(state, frequencies);
+    };
+
+    const int numSlopes = util::Params::getSlopeNames().size();
+    for (int slopeIndex = 0; slopeIndex < numSlopes; ++slopeIndex) {
+        const int order = util::getFilterOrder(static_cast<util::Slope>(slopeIndex));
+        const auto label = std::to_string(order * 6) + " dB/oct";
+
+        const auto highPass = measure(util::FilterType::HighPass, slopeIndex);
+        const auto lowPass = measure(util::FilterType::LowPass, slopeIndex);
+        ok &= expect(std::abs(highPass[1] + 3.01f) < 0.05f && std::abs(lowPass[1] + 3.01f) < 0.05f,
+                     "A Butterworth " + label + " cut should be 3 dB down at its corner");
+
+        // Bilinear warping moves the octave below a little; it stays within 0.1 dB while the level is on screen.
+        const float expectedDb = -10.0f * std::log10(1.0f + std::pow(4.0f, static_cast<float>(order)));
+        if (order <= 7)
+            ok &= expect(std::abs(highPass[0] - expectedDb) < 0.1f,
+                         "A Butterworth " + label + " high-pass should fall at its order an octave below the corner");
+
+        const auto linkwitzRiley = measure(util::FilterType::LowPassLR, slopeIndex);
+        ok &= expect(std::abs(linkwitzRiley[1] + 6.02f) < 0.05f,
+                     "A Linkwitz-Riley " + label + " cut should be 6 dB down at its corner");
+    }
+
+    const int order16 = util::getFilterOrder(util::Slope::Slope96dB);
+    ok &= expect(::dsp::CutFilterDesign::getNumSections(util::FilterType::HighPass, util::Slope::Slope96dB) ==
+                     order16 / 2,
+                 "A 96 dB/oct cut should run eight sections");
+    ok &= expect(::dsp::CutFilterDesign::getNumSections(util::FilterType::HighPassLR, util::Slope::Slope18dB) == 2,
+                 "An odd Linkwitz-Riley slope should round up to the next even order");
+
+    // The audio path: a 96 dB/oct high-pass leaves a tone an octave below ~90 dB quieter than a 12 dB/oct one would.
+    juce::dsp::ProcessSpec spec;
+    spec.sampleRate = 48000.0;
+    spec.maximumBlockSize = 256;
+    spec.numChannels = 2;
+
+    BandStorage storage;
+    storage.type.store(static_cast<float>(util::FilterType::HighPass));
+    storage.freq.store(1000.0f);
+    storage.q.store(util::Params::defaultQ());
+    auto params = storage.asParams();
+
+    juce::AudioBuffer<float> buffer(2, 256);
+    constexpr int numBlocks = 200;
+    auto run = [&](util::Slope slope) {
+        ::dsp::EqBand band;
+        band.prepare(spec);
+        storage.cutSlope.store(static_cast<float>(slope));
+
+        double phase = 0.0;
+        float rms = 0.0f;
+        for (int block = 0; block < numBlocks; ++block) {
+            fillSine(buffer, spec.sampleRate, 500.0, phase);
+            band.updateCoefficients(params, spec.sampleRate, buffer.getNumSamples());
+            juce::dsp::AudioBlock<float> blockView(buffer);
+            juce::dsp::ProcessContextReplacing<float> context(blockView);
+            band.process(context);
+            rms = computeRms(buffer, 0);
+        }
+        return rms;
+    };
+
+    const float order2Rms = run(util::Slope::Slope12dB);
+    const float order16Rms = run(util::Slope::Slope96dB);
+    const float attenuationDb = juce::Decibels::gainToDecibels(order16Rms / order2Rms, -200.0f);
+    ok &= expect(attenuationDb < -80.0f, "A 96 dB/oct cut should attenuate far more than a 12 dB/oct one");
+
+    return ok;
+}
+
+bool testTripleBufferHandsOffLatestValue() {
+    util::TripleBuffer<std::vector<float>> buffer;
+
+    bool ok = expect(!buffer.acquire(), "Triple buffer should start with nothing to read");
+
+    for (int value = 1; value <= 3; ++value) {
+        buffer.getWriteBuffer().assign(4, static_cast<float>(value));
+        buffer.publish();
+    }
+
+    ok &= expect(buffer.acquire(), "Triple buffer should report a published value");
+    ok &= expect(buffer.getReadBuffer().size() == 4 && buffer.getReadBuffer()[0] == 3.0f,
+                 "Triple buffer reader should only see the latest published value");
+    ok &= expect(!buffer.acquire(), "Triple buffer should not report the same value twice");
+
+    // Reader keeps its slot while the writer publishes into the other two.
+    buffer.getWriteBuffer().assign(2, 4.0f);
+    ok &= expect(buffer.getReadBuffer()[0] == 3.0f, "Writing should never touch the slot being read");
+    buffer.publish();
+    ok &= expect(buffer.acquire() && buffer.getReadBuffer()[0] == 4.0f, "Reader should pick up the next value");
+
+    return ok;
+}
+
+bool testAnalysisSchedulerCoalescesRequests() {
+    struct CountingClient final : ui::AnalysisScheduler::Client {
+        std::atomic<int> runs{0};
+        juce::WaitableEvent started;
+        juce::WaitableEvent release;
+        bool blockFirstRun = false;
+
+        void runAnalysis() override {
+            const int run = runs.fetch_add(1) + 1;
+            started.signal();
+            if (blockFirstRun && run == 1)
+                release.wait(2000);
+        }
+    };
+
+    juce::SharedResourcePointer<ui::AnalysisScheduler> scheduler;
+    CountingClient busy;
+    CountingClient first;
+    CountingClient second;
+    busy.blockFirstRun = true;
+
+    scheduler->requestAnalysis(busy);
+    const bool busyStarted = busy.started.wait(2000);
+
+    // While running, any number of requests collapse into a single rerun; while queued, into nothing.
+    for (int frame = 0; frame < 5; ++frame) {
+        scheduler->requestAnalysis(busy);
+        scheduler->requestAnalysis(first);
+        scheduler->requestAnalysis(second);
+    }
+    busy.release.signal();
+
+    auto waitForRuns = [](const CountingClient& client, int expectedRuns) {
+        for (int attempt = 0; attempt < 200 && client.runs.load() < expectedRuns; ++attempt)
+            juce::Thread::sleep(5);
+        return client.runs.load() == expectedRuns;
+    };
+
+    const bool settled = waitForRuns(busy, 2) && waitForRuns(first, 1) && waitForRuns(second, 1);
+    juce::Thread::sleep(20);
+
+    scheduler->cancel(busy);
+    scheduler->cancel(first);
+    scheduler->cancel(second);
+
+    return expect(busyStarted, "Scheduler should run a requested client") &&
+           expect(settled && busy.runs.load() == 2 && first.runs.load() == 1 && second.runs.load() == 1,
+                  "Scheduler should coalesce repeated requests per client");
+}
+
+bool testMultiResolutionAnalyzerResolvesLowAndHighTones() {
+    constexpr double sampleRate = 48000.0;
+    ::dsp::MultiResolutionAnalyzer analyzer;
+    analyzer.prepare(sampleRate);
+
+    const auto& frequencies = analyzer.getFrequencies();
+    std::vector<float> power(frequencies.size());
+    std::vector<float> input(static_cast<std::size_t>(sampleRate * 2.0));
+
+    auto analyseTone = [&](double toneHz) {
+        for (std::size_t i = 0; i < input.size(); ++i)
+            input[i] = 0.5f * static_cast<float>(std::sin(juce::MathConstants<double>::twoPi * toneHz *
+                                                          static_cast<double>(i) / sampleRate));
+
+        analyzer.reset();
+        analyzer.push(input.data(), static_cast<int>(input.size()));
+        analyzer.getPowerSpectrum(power.data());
+
+        const auto peak = static_cast<std::size_t>(std::max_element(power.begin(), power.end()) - power.begin());
+        return std::make_pair(frequencies[peak], 10.0f * std::log10(power[peak]));
+    };
+
+    bool ok = expect(analyzer.getNumStages() >= 6, "48 kHz analysis should cascade several octave stages");
+
+    for (const double toneHz : {45.0, 5000.0}) {
+        const auto [peakHz, peakDb] = analyseTone(toneHz);
+        ok &= expect(std::abs(peakHz - toneHz) < toneHz * 0.03,
+                     "Multi-resolution peak should sit on the tone (" + std::to_string(peakHz) + " Hz)");
+        ok &= expect(std::abs(peakDb + 6.0f) < 2.0f,
+                     "Multi-resolution peak level should match a -6 dBFS sine (" + std::to_string(peakDb) + " dB)");
+    }
+
+    // A high tone must not leak into the decimated low stages.
+    analyseTone(15000.0);
+    float worstLowDb = -200.0f;
+    for (std::size_t p = 0; p < frequencies.size() && frequencies[p] < 2000.0f; ++p)
+        worstLowDb = std::max(worstLowDb, 10.0f * std::log10(std::max(power[p], 1.0e-20f)));
+    ok &= expect(worstLowDb < -60.0f,
+                 "Decimated stages should reject high-frequency content (" + std::to_string(worstLowDb) + " dB)");
+
+    return ok;
+}
+
+bool testOctaveSmootherAveragesFractionalOctave() {
+    constexpr int numBins = 2049;
+    constexpr float binSpacingHz = 48000.0f / 4096.0f;
+    std::vector<float> frequencies(numBins);
+    for (int bin = 0; bin < numBins; ++bin)
+        frequencies[static_cast<std::size_t>(bin)] = static_cast<float>(bin) * binSpacingHz;
+
+    ::dsp::OctaveSmoother smoother;
+    smoother.prepare(frequencies, 3);
+
+    std::vector<float> power(numBins, 0.25f);
+    std::vector<float> smoothed(numBins);
+    smoother.process(power.data(), smoothed.data());
+
+    bool ok = true;
+    float worstFlatError = 0.0f;
+    for (const float value : smoothed)
+        worstFlatError = std::max(worstFlatError, std::abs(value - 0.25f));
+    ok &= expect(worstFlatError < 1.0e-6f, "Smoothing must leave a flat spectrum unchanged");
+
+    // A single spike at ~1 kHz spreads over the bins within 1/6 octave either side and nowhere else.
+    std::fill(power.begin(), power.end(), 0.0f);
+    const int spikeBin = static_cast<int>(std::lround(1000.0f / binSpacingHz));
+    power[static_cast<std::size_t>(spikeBin)] = 1.0f;
+    smoother.process(power.data(), smoothed.data());
+
+    const float spikeHz = frequencies[static_cast<std::size_t>(spikeBin)];
+    const float edge = std::exp2(1.0f / 6.0f);
+    bool spreadCorrectly = smoothed[static_cast<std::size_t>(spikeBin)] > 0.0f;
+    for (int bin = 1; bin < numBins; ++bin) {
+        const float frequency = frequencies[static_cast<std::size_t>(bin)];
+        const bool covers = spikeHz >= frequency / edge && spikeHz <= frequency * edge;
+        const bool lit = smoothed[static_cast<std::size_t>(bin)] > 0.0f;
+        spreadCorrectly = spreadCorrectly && covers == lit;
+    }
+    ok &= expect(spreadCorrectly, "1/3 octave smoothing should spread a spike exactly over its octave window");
+
+    const int windowBins = static_cast<int>(std::count_if(frequencies.begin(), frequencies.end(), [&](float f) {
+        return f >= spikeHz / edge && f <= spikeHz * edge;
+    }));
+    ok &= expect(std::abs(smoothed[static_cast<std::size_t>(spikeBin)] - 1.0f / static_cast<float>(windowBins)) <
+                     1.0e-6f,
+                 "Smoothed spike should be the window mean");
+
+    smoother.prepare(frequencies, 0);
+    ok &= expect(!smoother.isActive(), "Fraction 0 should disable smoothing");
+    return ok;
+}
+
+bool testAnalyzerFifoSharesIndicesAcrossPlanes() {
+    using Fifo = util::AnalyzerFifo<2>;
+    auto fifo = std::make_unique<Fifo>();
+
+    constexpr int blockSize = 1000;
+    std::vector<float> pre(blockSize);
+    std::vector<float> post(blockSize);
+    bool ok = true;
+    int nextValue = 0;
+    int expectedValue = 0;
+
+    // Push enough blocks to wrap the ring several times, reading frames with overlap like the analyzer does.
+    for (int block = 0; block < 3 * Fifo::Capacity / blockSize; ++block) {
+        for (int i = 0; i < blockSize; ++i) {
+            pre[static_cast<std::size_t>(i)] = static_cast<float>(nextValue % 65521);
+            post[static_cast<std::size_t>(i)] = -static_cast<float>(nextValue % 65521);
+            ++nextValue;
+        }
+
+        const int readyBeforeWrite = fifo->getNumReady();
+        ok &= expect(fifo->beginWrite(blockSize) == blockSize, "FIFO should accept a block while being drained");
+        fifo->writePlane(0, pre.data());
+        fifo->writePlane(1, post.data());
+        ok &= expect(fifo->getNumReady() == readyBeforeWrite,
+                     "Reserved samples must not be visible before finishWrite");
+        fifo->finishWrite();
+
+        constexpr int frameSize = 4096;
+        constexpr int hopSize = 1024;
+        while (fifo->getNumReady() >= frameSize) {
+            const auto region = fifo->prepareRead(frameSize);
+            ok &= expect(region.getTotalSize() == frameSize, "Frame region should cover the whole frame");
+
+            const float* prePlane = fifo->getPlane(0);
+            const float* postPlane = fifo->getPlane(1);
+            for (int i = 0; i < frameSize; ++i) {
+                const int index = i < region.size1 ? region.start1 + i : region.start2 + (i - region.size1);
+                const auto expected = static_cast<float>((expectedValue + i) % 65521);
+                ok &= expect(prePlane[index] == expected && postPlane[index] == -expected,
+                             "Planes should stay aligned and in order across the wrap");
+                if (!ok)
+                    return false;
+            }
+
+            fifo->finishRead(hopSize);
+            expectedValue += hopSize;
+        }
+    }
+
+    return ok;
+}
+
+bool testParameterHandlesMatchIdTable() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    bool ok = true;
+
+    ok &= expect(juce::String(util::Params::IDs::freq(3, util::Bank::B)) == "b3_b_freq",
+                 "Band IDs should follow the b<band>_<bank>_<field> scheme");
+    ok &= expect(util::Params::IDs::enabled(1) == util::Params::IDs::enabled(1),
+                 "Band IDs should come from a shared table, not be rebuilt per call");
+
+    for (int i = 0; i < util::Params::MaxBands; ++i) {
+        for (int f = 0; f < util::Params::NumBandFields; ++f) {
+            const auto field = static_cast<util::BandField>(f);
+            for (const auto bank : {util::Bank::A, util::Bank::B}) {
+                auto* handle = params.handle(i, bank, field);
+                auto* byId = params.apvts.getParameter(util::Params::IDs::field(i + 1, field, bank));
+                ok &= expect(handle != nullptr && handle == byId,
+                             "Parameter handles should resolve to the parameter with the matching ID");
+            }
+        }
+    }
+
+    return ok;
+}
+
+bool testLinkMirrorKeepsBanksInStep() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::LinkMirror mirror(params);
+    bool ok = true;
+
+    auto set = [&](int band, util::Bank bank, util::BandField field, float value) {
+        auto& parameter = *params.handle(band, bank, field);
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+    };
+    auto get = [&](int band, util::Bank bank) { return params.getBand(band, bank).freq->load(); };
+
+    ok &= expect(params.getEditTarget() == util::EditTarget::Link, "Edit target should default to Link");
+    set(2, util::Bank::A, util::BandField::Frequency, 321.0f);
+    ok &= expect(std::abs(get(2, util::Bank::B) - 321.0f) < 0.1f, "Link should mirror bank A edits to bank B");
+    set(5, util::Bank::B, util::BandField::Frequency, 4321.0f);
+    ok &= expect(std::abs(get(5, util::Bank::A) - 4321.0f) < 0.1f, "Link should mirror bank B edits to bank A");
+
+    auto& editTarget = params.getEditTargetParameter();
+    editTarget.setValueNotifyingHost(editTarget.convertTo0to1(static_cast<float>(util::EditTarget::A)));
+    set(2, util::Bank::A, util::BandField::Frequency, 800.0f);
+    ok &= expect(std::abs(get(2, util::Bank::B) - 321.0f) < 0.1f, "Banks should be independent outside Link");
+
+    editTarget.setValueNotifyingHost(editTarget.convertTo0to1(static_cast<float>(util::EditTarget::Link)));
+    ok &= expect(std::abs(get(2, util::Bank::B) - 800.0f) < 0.1f, "Engaging Link should copy bank A over bank B");
+
+    mirror.setSuspended(true);
+    set(2, util::Bank::B, util::BandField::Frequency, 90.0f);
+    mirror.setSuspended(false);
+    ok &= expect(std::abs(get(2, util::Bank::A) - 800.0f) < 0.1f, "A suspended mirror should not copy values");
+    mirror.synchronise();
+    ok &= expect(std::abs(get(2, util::Bank::B) - 800.0f) < 0.1f, "synchronise() should copy bank A over bank B");
+    return ok;
+}
+
+bool testFramePacerCapsRateAndBacksOffUnderLoad() {
+    bool ok = true;
+
+    // 144 Hz display, cheap frames: every second refresh renders, i.e. 72 fps.
+    ui::FramePacer pacer;
+    constexpr double interval144 = 1000.0 / 144.0;
+    double now = 0.0;
+    int frames = 0;
+    for (int vBlank = 0; vBlank < 1440; ++vBlank) {
+        if (pacer.onVBlank(now)) {
+            ++frames;
+            pacer.reportFrameCost(0.5);
+        }
+        now += interval144;
+    }
+    ok &= expect(pacer.getDivider() == 2, "A 144 Hz display should render every second refresh");
+    ok &= expect(frames > 700 && frames < 760, "Cheap frames at 144 Hz should run near 72 fps");
+
+    // 60 Hz display with frames costing 20 ms: the rate drops until a frame fits half its period.
+    ui::FramePacer loaded;
+    constexpr double interval60 = 1000.0 / 60.0;
+    now = 0.0;
+    for (int vBlank = 0; vBlank < 600; ++vBlank) {
+        if (loaded.onVBlank(now))
+            loaded.reportFrameCost(20.0);
+        now += interval60;
+    }
+    ok &= expect(loaded.getDivider() == 3, "20 ms frames at 60 Hz should run at a third of the rate");
+
+    // Load goes away: back to every refresh.
+    for (int vBlank = 0; vBlank < 600; ++vBlank) {
+        if (loaded.onVBlank(now))
+            loaded.reportFrameCost(1.0);
+        now += interval60;
+    }
+    ok &= expect(loaded.getDivider() == 1, "Cheap frames should restore the full rate");
+
+    // A long gap (hidden window) must not be mistaken for a slow display.
+    static_cast<void>(loaded.onVBlank(now + 5000.0));
+    ok &= expect(std::abs(loaded.getVBlankIntervalMs() - interval60) < 0.5, "Gaps should not skew the interval");
+    return ok;
+}
+
+bool testPolylineSimplifierStaysWithinTolerance() {
+    ui::PolylineSimplifier simplifier;
+    bool ok = true;
+
+    std::vector<juce::Point<float>> line;
+    for (int i = 0; i < 500; ++i)
+        line.push_back({static_cast<float>(i), 10.0f + 0.5f * static_cast<float>(i)});
+
+    const auto& straight = simplifier.simplify(line, 0.25f);
+    ok &= expect(straight.size() == 2, "A straight line should reduce to its end points");
+
+    // A response-like curve: flat, a resonant bump and a narrow notch, one vertex per pixel.
+    std::vector<juce::Point<float>> curve;
+    for (int i = 0; i < 1400; ++i) {
+        const float x = static_cast<float>(i);
+        const float bump = 60.0f * std::exp(-std::pow((x - 400.0f) / 40.0f, 2.0f));
+        const float notch = i == 1000 ? -80.0f : 0.0f;
+        curve.push_back({x, 300.0f - bump - notch});
+    }
+
+    constexpr float tolerance = 0.25f;
+    const auto simplified = simplifier.simplify(curve, tolerance);
+    ok &= expect(simplified.size() < curve.size() / 10, "Smooth stretches should collapse to few vertices");
+    ok &= expect(simplified.front() == curve.front() && simplified.back() == curve.back(),
+                 "End points must be kept");
+    ok &= expect(std::any_of(simplified.begin(), simplified.end(),
+                             [](juce::Point<float> point) { return point.x == 1000.0f; }),
+                 "A single-pixel notch must survive simplification");
+
+    // Every input point must lie within the tolerance of the segment that replaced it; x is monotonic, so that is
+    // the segment spanning the point's x.
+    std::size_t segment = 0;
+    float worstError = 0.0f;
+    for (const auto& point : curve) {
+        while (segment + 2 < simplified.size() && simplified[segment + 1].x < point.x)
+            ++segment;
+
+        const auto start = simplified[segment];
+        const auto end = simplified[segment + 1];
+        const auto direction = end - start;
+        const float t = ((point - start).x * direction.x + (point - start).y * direction.y) /
+                        (direction.x * direction.x + direction.y * direction.y);
+        const auto nearest = start + direction * juce::jlimit(0.0f, 1.0f, t);
+        worstError = std::max(worstError, point.getDistanceFrom(nearest));
+    }
+
+    ok &= expect(worstError <= tolerance + 1.0e-3f, "Simplified curve should stay within the tolerance");
+    return ok;
+}
 } // namespace
 
+bool testGestureWriterCoalescesDragWrites() {
+    struct CountingListener final : juce::AudioProcessorParameter::Listener {
+        int values = 0;
+        int gestureStarts = 0;
+        int gestureEnds = 0;
+
+        void parameterValueChanged(int, float) override { ++values; }
+        void parameterGestureChanged(int, bool starting) override { ++(starting ? gestureStarts : gestureEnds); }
+    };
+
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::LinkMirror mirror(params);
+    bool ok = true;
+
+    auto& freqA = *params.handle(3, util::Bank::A, util::BandField::Frequency);
+    auto& freqB = *params.handle(3, util::Bank::B, util::BandField::Frequency);
+    CountingListener listenerA;
+    CountingListener listenerB;
+    freqA.addListener(&listenerA);
+    freqB.addListener(&listenerB);
+
+    {
+        ui::ParameterGestureWriter writer;
+        writer.begin();
+        for (int i = 0; i < 10; ++i)
+            writer.set(freqA, 500.0f + static_cast<float>(i) * 10.0f);
+
+        ok &= expect(listenerA.gestureStarts == 1 && listenerA.values == 0,
+                     "A drag should open one gesture and hold its writes until the frame flush");
+        writer.flush();
+        ok &= expect(listenerA.values == 1, "A frame flush should send one value per touched parameter");
+        writer.flush();
+        ok &= expect(listenerA.values == 1, "A flush with nothing new should not notify the host");
+
+        writer.set(freqA, 700.0f);
+        writer.end();
+        ok &= expect(listenerA.values == 2 && listenerA.gestureEnds == 1, "Ending a drag should flush and close it");
+        ok &= expect(std::abs(params.getBand(3, util::Bank::A).freq->load() - 700.0f) < 0.1f,
+                     "The last value of a drag should be the one written");
+        ok &= expect(listenerB.gestureStarts == 1 && listenerB.gestureEnds == 1 && listenerB.values == 2,
+                     "Link mode should mirror the gesture and the coalesced writes to bank B");
+
+        writer.set(freqA, 900.0f);
+        ok &= expect(listenerA.values == 3 && listenerA.gestureStarts == 2 && listenerA.gestureEnds == 2,
+                     "A write outside a drag should go out at once inside its own gesture");
+    }
+
+    freqA.removeListener(&listenerA);
+    freqB.removeListener(&listenerB);
+    return ok;
+}
+
+bool testStateSerializerRoundTripsAndRejectsDamage() {
+    DummyProcessor sourceProcessor;
+    util::Params source(sourceProcessor);
+    DummyProcessor targetProcessor;
+    util::Params target(targetProcessor);
+    util::StateSerializer sourceSerializer(source);
+    util::StateSerializer targetSerializer(target);
+    bool ok = true;
+
+    auto set = [](util::Params& params, int band, util::Bank bank, util::BandField field, float value) {
+        auto& parameter = *params.handle(band, bank, field);
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+    };
+    set(source, 0, util::Bank::A, util::BandField::Frequency, 87.0f);
+    set(source, 4, util::Bank::B, util::BandField::Gain, -7.5f);
+    set(source, 6, util::Bank::A, util::BandField::Slope, 2.0f);
+    auto& stereoMode = *source.apvts.getParameter(util::Params::IDs::stereoMode);
+    stereoMode.setValueNotifyingHost(stereoMode.convertTo0to1(1.0f));
+
+    juce::MemoryBlock chunk;
+    sourceSerializer.save(chunk);
+    const int chunkSize = static_cast<int>(chunk.getSize());
+    ok &= expect(util::StateSerializer::isBinaryState(chunk.getData(), chunkSize), "Saved state should be binary");
+    ok &= expect(targetSerializer.load(chunk.getData(), chunkSize), "A saved chunk should load");
+
+    bool allMatch = true;
+    for (auto* parameter : sourceProcessor.getParameters()) {
+        const auto* withId = dynamic_cast<juce::AudioProcessorParameterWithID*>(parameter);
+        const auto* loaded = withId != nullptr ? target.apvts.getParameter(withId->paramID) : nullptr;
+        allMatch = allMatch && loaded != nullptr && std::abs(loaded->getValue() - parameter->getValue()) < 1.0e-6f;
+    }
+    ok &= expect(allMatch, "Every parameter should survive a binary round trip");
+
+    auto damaged = chunk;
+    static_cast<char*>(damaged.getData())[20] ^= 0x10;
+    set(target, 0, util::Bank::A, util::BandField::Frequency, 1234.0f);
+    ok &= expect(!targetSerializer.load(damaged.getData(), chunkSize), "A damaged chunk should be rejected");
+    ok &= expect(!targetSerializer.load(chunk.getData(), chunkSize - 1), "A truncated chunk should be rejected");
+    ok &= expect(std::abs(target.getBand(0, util::Bank::A).freq->load() - 1234.0f) < 0.1f,
+                 "A rejected chunk should leave the parameters untouched");
+
+    juce::MemoryBlock xmlChunk;
+    juce::AudioProcessor::copyXmlToBinary(*source.apvts.copyState().createXml(), xmlChunk);
+    ok &= expect(chunk.getSize() < xmlChunk.getSize(), "The binary chunk should be smaller than the XML state");
+    return ok;
+}
+
+// An XML state the way sessions from before the binary format hold it: the APVTS tree, with eight bands per bank.
+juce::MemoryBlock makeLegacyXmlState(const util::Params& params) {
+    juce::XmlElement xml(params.apvts.state.getType().toString());
+    for (const auto bank : {util::Bank::A, util::Bank::B}) {
+        for (int i = 0; i < util::Params::DefaultBandCount; ++i) {
+            // Those sessions had no cut slope or shape.
+            for (int f = 0; f <= static_cast<int>(util::BandField::Slope); ++f) {
+                const auto& parameter = *params.handle(i, bank, static_cast<util::BandField>(f));
+                auto* child = xml.createNewChildElement("PARAM");
+                child->setAttribute("id", parameter.paramID);
+                child->setAttribute("value", static_cast<double>(parameter.convertFrom0to1(parameter.getValue())));
+            }
+        }
+    }
+
+    juce::MemoryBlock data;
+    juce::AudioProcessor::copyXmlToBinary(xml, data);
+    return data;
+}
+
+bool testLegacyXmlResetsBandsPastTheSession() {
+    DummyProcessor sourceProcessor;
+    util::Params source(sourceProcessor);
+    auto& sourceGain = *source.handle(2, util::Bank::A, util::BandField::Gain);
+    sourceGain.setValueNotifyingHost(sourceGain.convertTo0to1(4.5f));
+    const auto legacyState = makeLegacyXmlState(source);
+
+    DummyProcessor targetProcessor;
+    util::Params target(targetProcessor);
+    util::StateSerializer targetSerializer(target);
+    for (const auto bank : {util::Bank::A, util::Bank::B}) {
+        auto& enabled = *target.handle(11, bank, util::BandField::Enabled);
+        enabled.setValueNotifyingHost(1.0f);
+        auto& frequency = *target.handle(11, bank, util::BandField::Frequency);
+        frequency.setValueNotifyingHost(frequency.convertTo0to1(5000.0f));
+    }
+    bool ok = true;
+
+    ok &= expect(!targetSerializer.loadLegacyXml("not xml", 7), "Data that is not an XML state should be rejected");
+    ok &= expect(target.getBand(11).enabled->load() >= 0.5f, "A rejected state should leave the parameters untouched");
+    ok &= expect(targetSerializer.loadLegacyXml(legacyState.getData(), static_cast<int>(legacyState.getSize())),
+                 "A legacy XML state should load");
+    ok &= expect(std::abs(target.getBand(2).gain->load() - 4.5f) < 0.01f, "Saved bands should be applied");
+
+    bool pastBandsReset = true;
+    for (const auto bank : {util::Bank::A, util::Bank::B}) {
+        for (int f = 0; f < util::Params::NumBandFields; ++f) {
+            const auto& parameter = *target.handle(11, bank, static_cast<util::BandField>(f));
+            pastBandsReset = pastBandsReset && parameter.getValue() == parameter.getDefaultValue();
+        }
+    }
+    ok &= expect(pastBandsReset, "Bands the legacy state lacks should be reset to defaults in both banks");
+    ok &= expect(target.getUsedBandCount() == util::Params::DefaultBandCount,
+                 "After a legacy load only the legacy bands should be in use");
+
+    return ok;
+}
+
+bool testLegacyXmlUpgradesOnlySavedSlopes() {
+    DummyProcessor sourceProcessor;
+    util::Params source(sourceProcessor);
+    auto setSource = [&source](int band, util::BandField field, float value) {
+        auto& parameter = *source.handle(band, util::Bank::A, field);
+        parameter.setValueNotifyingHost(parameter.convertTo0to1(value));
+    };
+    // Legacy slope indices: 1 was a 24 dB/oct cut; on a bell 0 was just the stored default.
+    setSource(0, util::BandField::Type, static_cast<float>(util::FilterType::HighPass));
+    setSource(0, util::BandField::Slope, 1.0f);
+    setSource(1, util::BandField::Type, static_cast<float>(util::FilterType::Peak));
+    setSource(1, util::BandField::Slope, 0.0f);
+    setSource(1, util::BandField::Q, 2.5f);
+    const auto legacyState = makeLegacyXmlState(source);
+
+    DummyProcessor targetProcessor;
+    util::Params target(targetProcessor);
+    util::StateSerializer targetSerializer(target);
+    auto& pastSlope = *target.handle(20, util::Bank::B, util::BandField::CutSlope);
+    pastSlope.setValueNotifyingHost(pastSlope.convertTo0to1(6.0f));
+    bool ok = true;
+
+    ok &= expect(targetSerializer.loadLegacyXml(legacyState.getData(), static_cast<int>(legacyState.getSize())),
+                 "A legacy XML state should load");
+    ok &= expect(target.getBand(0).cutSlope->load() == static_cast<float>(util::Slope::Slope24dB) &&
+                     target.getBand(0).slope->load() == 1.0f,
+                 "A saved legacy cut slope should be upgraded to its cut slope and kept as it was");
+    ok &= expect(target.getBand(1).cutSlope->load() == static_cast<float>(util::Slope::Slope12dB) &&
+                     std::abs(target.getBand(1).q->load() - 2.5f) < 0.01f,
+                 "A bell's legacy slope should be upgraded and its Q left alone");
+
+    bool unsavedAtDefault = true;
+    for (const auto bank : {util::Bank::A, util::Bank::B}) {
+        for (int i = util::Params::DefaultBandCount; i < util::Params::MaxBands; ++i) {
+            const auto& slope = *target.handle(i, bank, util::BandField::CutSlope);
+            const auto& q = *target.handle(i, bank, util::BandField::Q);
+            unsavedAtDefault = unsavedAtDefault && slope.getValue() == slope.getDefaultValue() &&
+                               q.getValue() == q.getDefaultValue();
+        }
+    }
+    ok &= expect(target.getBand(20, util::Bank::B).cutSlope->load() == static_cast<float>(util::Slope::Slope12dB) &&
+                     unsavedAtDefault,
+                 "Bands the legacy state lacks should get default slopes, not upgraded ones");
+
+    return ok;
+}
+
+// A chunk in the layout of versions 1 and 2: default globals, then eight bands of six fields per bank, at their
+// defaults except for the given values of bank A.
+struct ChunkField {
+    int band = 0;
+    util::BandField field = util::BandField::Enabled;
+    float value = 0.0f;
+};
+
+juce::MemoryBlock makeSixFieldChunk(const util::Params& params, int version, const std::vector<ChunkField>& bankA) {
+    std::vector<std::uint8_t> bytes;
+    auto writeUInt = [&bytes](std::uint32_t value, int numBytes) {
+        for (int i = 0; i < numBytes; ++i)
+            bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+    };
+    auto writeFloat = [&writeUInt](float value) {
+        std::uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        writeUInt(bits, 4);
+    };
+
+    writeUInt(util::StateSerializer::Magic, 4);
+    writeUInt(static_cast<std::uint32_t>(version), 2);
+    writeUInt(static_cast<std::uint32_t>(util::Params::DefaultBandCount), 2);
+    for (const char* id : {util::Params::IDs::outputGain, util::Params::IDs::stereoMode, util::Params::IDs::hqMode,
+                           util::Params::IDs::editTarget}) {
+        const auto& parameter = *params.apvts.getParameter(id);
+        writeFloat(parameter.convertFrom0to1(parameter.getDefaultValue()));
+    }
+
+    for (const auto bank : {util::Bank::A, util::Bank::B}) {
+        for (int i = 0; i < util::Params::DefaultBandCount; ++i) {
+            for (int f = 0; f <= static_cast<int>(util::BandField::Slope); ++f) {
+                const auto field = static_cast<util::BandField>(f);
+                const auto& parameter = *params.handle(i, bank, field);
+                float value = parameter.convertFrom0to1(parameter.getDefaultValue());
+                for (const auto& given : bankA) {
+                    if (bank == util::Bank::A && given.band == i && given.field == field)
+                        value = given.value;
+                }
+                writeFloat(value);
+            }
+        }
+    }
+
+    std::uint32_t checksum = 2166136261U;
+    for (const auto byte : bytes) {
+        checksum ^= byte;
+        checksum *= 16777619U;
+    }
+    writeUInt(checksum, 4);
+    return {bytes.data(), bytes.size()};
+}
+
+bool testLegacyCutSlopesUpgradeOnLoad() {
+    bool ok = true;
+
+    float slope = 0.0f;
+    float q = 0.707f;
+    util::Params::upgradeLegacySlope(util::FilterType::HighPass, 0.0f, slope, q);
+    ok &= expect(slope == static_cast<float>(util::Slope::Slope12dB) && std::abs(q - 1.0f) < 0.01f,
+                 "A legacy 12 dB cut at Q 0.707 should become the flat 12 dB Butterworth");
+
+    q = 0.707f;
+    util::Params::upgradeLegacySlope(util::FilterType::LowPass, 3.0f, slope, q);
+    ok &= expect(slope == static_cast<float>(util::Slope::Slope48dB) && q == 0.707f,
+                 "A legacy 48 dB cut should keep its slope");
+
+    DummyProcessor processor;
+    util::Params target(processor);
+    util::StateSerializer serializer(target);
+
+    // Version 1: legacy slope index 1 was 24 dB/oct.
+    const auto version1 = makeSixFieldChunk(target, 1, {{0, util::BandField::Slope, 1.0f}});
+    ok &= expect(serializer.load(version1.getData(), static_cast<int>(version1.getSize())),
+                 "A version 1 chunk should load");
+    ok &= expect(target.getBand(0).cutSlope->load() == static_cast<float>(util::Slope::Slope24dB) &&
+                     target.getBand(0).slope->load() == 1.0f,
+                 "A version 1 slope should become the matching cut slope");
+
+    // Version 2: the slope field was the cut slope, and types 5 and 6 were the Linkwitz-Riley cuts.
+    const auto version2 = makeSixFieldChunk(
+        target, 2,
+        {{0, util::BandField::Type, static_cast<float>(util::FilterType::HighPassLR)},
+         {0, util::BandField::Slope, static_cast<float>(util::Slope::Slope36dB)},
+         {7, util::BandField::Type, static_cast<float>(util::FilterType::LowPass)},
+         {7, util::BandField::Slope, static_cast<float>(util::Slope::Slope18dB)}});
+    ok &= expect(serializer.load(version2.getData(), static_cast<int>(version2.getSize())),
+                 "A version 2 chunk should load");
+    ok &= expect(target.getBand(0).getFilterType() == util::FilterType::HighPassLR &&
+                     target.getBand(0).type->load() == static_cast<float>(util::FilterType::HighPass) &&
+                     target.getBand(0).getSlope() == util::Slope::Slope36dB,
+                 "A version 2 Linkwitz-Riley cut should become a high pass with that shape");
+    ok &= expect(target.getBand(7).getFilterType() == util::FilterType::LowPass &&
+                     target.getBand(7).getSlope() == util::Slope::Slope18dB &&
+                     target.getBand(7).slope->load() == static_cast<float>(util::Params::defaultLegacySlopeIndex()),
+                 "A version 2 slope should move to the cut slope");
+
+    juce::MemoryBlock current;
+    serializer.save(current);
+    DummyProcessor copyProcessor;
+    util::Params copy(copyProcessor);
+    util::StateSerializer copySerializer(copy);
+    ok &= expect(copySerializer.load(current.getData(), static_cast<int>(current.getSize())) &&
+                     copy.getBand(0).getFilterType() == util::FilterType::HighPassLR &&
+                     copy.getBand(7).getSlope() == util::Slope::Slope18dB,
+                 "Cut slopes and shapes should survive a round trip");
+
+    return ok;
+}
+
+bool testLegacySlopeAutomationStillWorks() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::LegacySlopeForwarder forwarder(params);
+    bool ok = true;
+
+    const auto& type = *params.handle(0, util::Bank::A, util::BandField::Type);
+    const auto& legacySlope = *params.handle(0, util::Bank::A, util::BandField::Slope);
+    ok &= expect(dynamic_cast<const juce::AudioParameterChoice&>(type).choices.size() == 5 &&
+                     dynamic_cast<const juce::AudioParameterChoice&>(legacySlope).choices.size() == 4,
+                 "The type and slope parameters should keep the choices automation was recorded against");
+
+    auto& automated = *params.handle(0, util::Bank::B, util::BandField::Slope);
+    automated.setValueNotifyingHost(automated.convertTo0to1(2.0f));
+    ok &= expect(params.getBand(0, util::Bank::B).getSlope() == util::Slope::Slope36dB,
+                 "Automating a legacy slope should move the band's cut slope to match");
+
+    forwarder.setSuspended(true);
+    automated.setValueNotifyingHost(automated.convertTo0to1(0.0f));
+    ok &= expect(params.getBand(0, util::Bank::B).getSlope() == util::Slope::Slope36dB,
+                 "A suspended forwarder should leave the cut slope alone");
+
+    return ok;
+}
+
+bool testPresetBankIndexesAndSwitchesQuickly() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::StateSerializer serializer(params);
+    auto& gain = *params.handle(3, util::Bank::A, util::BandField::Gain);
+    bool ok = true;
+
+    constexpr int numPresets = 2000;
+    std::vector<util::PresetBank::Entry> entries(static_cast<std::size_t>(numPresets));
+    for (int i = 0; i < numPresets; ++i) {
+        auto& entry = entries[static_cast<std::size_t>(i)];
+        entry.name = "Preset " + juce::String(i);
+        entry.tags.add(i % 2 == 0 ? "Vocal" : "Drums");
+        gain.setValueNotifyingHost(gain.convertTo0to1(static_cast<float>(i % 37) - 18.0f));
+        serializer.save(entry.state);
+    }
+    entries.back().name = "Bright Vocal Air";
+
+    const auto file = juce::File::createTempFile(".eqbank");
+    util::PresetBank bank;
+    ok &= expect(util::PresetBank::write(file, entries) && bank.open(file), "A written bank should open");
+    ok &= expect(bank.size() == numPresets, "Every record should be indexed");
+    ok &= expect(bank.findByName("bright vocal air") == numPresets - 1, "Names should be found case-insensitively");
+    ok &= expect(bank.findByName("Missing") == -1, "Unknown names should not be found");
+    ok &= expect(bank.getPresetsWithTag("drums").size() == static_cast<std::size_t>(numPresets / 2),
+                 "Tags should index their presets");
+    const auto matches = bank.search("air voc");
+    ok &= expect(matches.size() == 1 && matches.front() == numPresets - 1,
+                 "Search should match every word against names and tag prefixes");
+    const auto indexBytes = bank.getMemoryFootprintBytes();
+    ok &= expect(indexBytes > numPresets * (sizeof(int) + sizeof(juce::String)) &&
+                     indexBytes < static_cast<std::size_t>(file.getSize()),
+                 "The footprint should cover the name index but not the mapped records");
+
+    // Step through the whole library the way a QA rig does.
+    bool allLoaded = true;
+    for (int i = 0; i < numPresets; ++i) {
+        const auto state = bank.getState(i);
+        allLoaded = serializer.load(state.data, state.size) && allLoaded;
+    }
+
+    ok &= expect(allLoaded, "Every preset state should load");
+    ok &= expect(std::abs(params.getBand(3).gain->load() - static_cast<float>((numPresets - 1) % 37 - 18)) < 0.01f,
+                 "The last preset switched to should be the one applied");
+
+    bank.close();
+    file.deleteFile();
+    ok &= expect(!bank.open(file) && bank.size() == 0, "A missing bank should open empty");
+    ok &= expect(bank.getMemoryFootprintBytes() == sizeof(bank), "An empty bank should hold no index");
+    return ok;
+}
+
+bool testParameterHistoryUndoesCoalescedDrags() {
+    DummyProcessor processor;
+    util::Params params(processor);
+    util::LinkMirror mirror(params);
+    util::ParameterHistory history(processor);
+    auto& freqA = *params.handle(2, util::Bank::A, util::BandField::Frequency);
+    auto& gainA = *params.handle(2, util::Bank::A, util::BandField::Gain);
+    const auto& bandA = params.getBand(2, util::Bank::A);
+    const auto& bandB = params.getBand(2, util::Bank::B);
+    const float startFreq = bandA.freq->load();
+    const auto emptyBytes = history.getMemoryFootprintBytes();
+    bool ok = true;
+
+    ui::ParameterGestureWriter writer;
+    writer.begin();
+    for (int i = 0; i < 200; ++i) {
+        writer.set(freqA, 200.0f + static_cast<float>(i) * 5.0f);
+        writer.set(gainA, static_cast<float>(i % 24) - 12.0f);
+        writer.flush();
+    }
+    writer.end();
+
+    ok &= expect(history.getNumUndoSteps() == 1, "A drag over two parameters should be one undo step");
+    ok &= expect(history.getMemoryFootprintBytes() < emptyBytes + 256,
+                 "A step should hold deltas, not every value the drag went through");
+
+    writer.begin();
+    writer.set(freqA, bandA.freq->load());
+    writer.end();
+    ok &= expect(history.getNumUndoSteps() == 1, "A gesture that changes nothing should not be recorded");
+
+    ok &= expect(history.undo() && std::abs(bandA.freq->load() - startFreq) < 0.1f &&
+                     std::abs(bandA.gain->load()) < 0.01f,
+                 "Undo should restore the values from before the drag");
+    ok &= expect(std::abs(bandB.freq->load() - startFreq) < 0.1f, "Undo should restore the mirrored bank too");
+    ok &= expect(!history.canUndo() && history.canRedo(), "An undone step should move to the redo side");
+    ok &= expect(history.redo() && std::abs(bandA.freq->load() - 1195.0f) < 0.5f &&
+                     std::abs(bandA.gain->load() + 5.0f) < 0.01f,
+                 "Redo should reapply the last values of the drag");
+
+    history.undo();
+    writer.set(gainA, 3.0f);
+    ok &= expect(history.canUndo() && !history.canRedo(), "A new edit should clear the redo steps");
+
+    freqA.setValueNotifyingHost(freqA.convertTo0to1(5000.0f));
+    ok &= expect(history.getNumUndoSteps() == 1,
+                 "Changes outside gestures, such as automation, should not be recorded");
+
+    constexpr std::size_t budgetBytes = 1024;
+    util::ParameterHistory bounded(processor, budgetBytes);
+    const auto boundedEmptyBytes = bounded.getMemoryFootprintBytes();
+    for (int i = 0; i < 1000; ++i)
+        writer.set(gainA, static_cast<float>(i % 2 == 0 ? 6 : -6));
+    ok &= expect(bounded.getNumUndoSteps() > 10 && bounded.getNumUndoSteps() < 1000,
+                 "The history should keep its newest steps and drop the oldest");
+    ok &= expect(bounded.getMemoryFootprintBytes() <= boundedEmptyBytes + budgetBytes + 64,
+                 "The history should stay within its memory budget");
+    return ok;
+}
+
 int main() {
     bool ok = true;
     ok &= testParamsIncludeMilestone2Ids();
     ok &= testGlobalModesDefaultToLRAndEco();
     ok &= testCutBandsDisabledByDefault();
     ok &= testEqBandProcessesAllChannels();
+    ok &= testEngineRecallSnapsAndCrossfades();
+    ok &= testBandsPastTheDefaultCountWorkAndCostNothingUnused();
     ok &= testLowPassCutoffRespondsToFrequencyChanges();
     ok &= testPeakBandRespondsToGainChanges();
+    ok &= testResponseCurveFrameLoopDoesNotAllocate();
+    ok &= testResponseCurveGroupDelayMatchesPhaseSlope();
+    ok &= testCutSlopesFollowTheirFilterFamily();
+    ok &= testAdaptiveResponseMatchesDenseEvaluation();
+    ok &= testTripleBufferHandsOffLatestValue();
+    ok &= testAnalysisSchedulerCoalescesRequests();
+    ok &= testMultiResolutionAnalyzerResolvesLowAndHighTones();
+    ok &= testOctaveSmootherAveragesFractionalOctave();
+    ok &= testAnalyzerFifoSharesIndicesAcrossPlanes();
+    ok &= testParameterHandlesMatchIdTable();
+    ok &= testLinkMirrorKeepsBanksInStep();
+    ok &= testGestureWriterCoalescesDragWrites();
+    ok &= testStateSerializerRoundTripsAndRejectsDamage();
+    ok &= testLegacyXmlResetsBandsPastTheSession();
+    ok &= testLegacyXmlUpgradesOnlySavedSlopes();
+    ok &= testLegacyCutSlopesUpgradeOnLoad();
+    ok &= testLegacySlopeAutomationStillWorks();
+    ok &= testPresetBankIndexesAndSwitchesQuickly();
+    ok &= testParameterHistoryUndoesCoalescedDrags();
+    ok &= testFramePacerCapsRateAndBacksOffUnderLoad();
+    ok &= testPolylineSimplifierStaysWithinTolerance();
 
     if (!ok)
         return 1;